@@ -0,0 +1,298 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "batch.h"
+#include "error.h"
+#include "utils.h"
+#include "constants.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+
+/* Represents a file of the batch */
+typedef struct Job {
+	char* file_name; /* Name of the file without its extension */
+	long size; /* Size of the source file, 0 if it cannot be read */
+	assembler_ctx* ctx; /* Context of the file, holds its messages once it is done */
+	int done; /* Flag if the file is assembled */
+} job;
+
+/* Represents the files a worker has left, the worker takes them from the head and thieves from the tail */
+typedef struct Queue {
+	int* jobs; /* Indexes of the jobs, largest file first */
+	int head; /* Index of the next job of the worker */
+	int tail; /* Index past the last job */
+	pthread_mutex_t lock;
+} queue;
+
+/* Represents the state shared by all the workers */
+typedef struct Batch {
+	job* jobs; /* Jobs in the order of the files */
+	int count; /* Amount of jobs */
+	queue* queues; /* Queue of each worker */
+	int workers; /* Amount of workers */
+	batch_assembler assemble; /* Function assembling a single file */
+	void* options; /* Options passed to every call of assemble */
+	pthread_mutex_t done_lock; /* Lock of the done flags */
+	pthread_cond_t done_signal; /* Signaled every time a file is done */
+} batch;
+
+/* Represents a worker thread and the queue it owns */
+typedef struct Worker {
+	batch* shared;
+	int id;
+	pthread_t thread;
+} worker;
+
+/* Represents a task run on a thread of its own */
+typedef struct Task {
+	batch_task run;
+	void* data;
+	int index;
+	pthread_t thread;
+} task;
+
+/* Represents a job while the jobs are ordered by size */
+typedef struct SizedJob {
+	long size;
+	int index;
+} sized_job;
+
+
+/* This function deals the jobs to the queues of the workers, largest file first */
+static void deal_jobs(batch*);
+/* This function compares two jobs by size, largest first and then by order */
+static int compare_sizes(const void*, const void*);
+/* This function runs a worker until every queue is empty */
+static void* run_worker(void*);
+/* This function takes the next job of a worker, stealing one if its queue is empty, INVALID if none is left */
+static int take_job(batch*, int);
+/* This function runs a task on its thread */
+static void* run_task(void*);
+/* This function returns the size of a source file, 0 if it cannot be read */
+static long file_size(char*);
+/* This function allocates a block of memory, exits on failure */
+static void* allocate(size_t);
+
+
+/*
+	This function assembles the files with a pool of workers, the calling thread
+	writes the messages of each file in order as soon as the file is done
+*/
+void batch_assemble(char** file_names, int count, int workers, batch_assembler assemble, void* options) {
+	batch shared;
+	worker* pool;
+	int i;
+	
+	if(workers > count) workers = count;
+	
+	shared.jobs = (job*)allocate(sizeof(job) * count);
+	shared.count = count;
+	shared.queues = (queue*)allocate(sizeof(queue) * workers);
+	shared.workers = workers;
+	shared.assemble = assemble;
+	shared.options = options;
+	pool = (worker*)allocate(sizeof(worker) * workers);
+	
+	for(i=0; i < count; i++) {
+		shared.jobs[i].file_name = file_names[i];
+		shared.jobs[i].size = file_size(file_names[i]);
+		shared.jobs[i].ctx = NULL;
+		shared.jobs[i].done = FALSE;
+	}
+	
+	deal_jobs(&shared);
+	pthread_mutex_init(&shared.done_lock, NULL);
+	pthread_cond_init(&shared.done_signal, NULL);
+	
+	for(i=0; i < workers; i++) {
+		pool[i].shared = &shared;
+		pool[i].id = i;
+	
+		if(pthread_create(&pool[i].thread, NULL, run_worker, &pool[i]) != 0) {
+			raise_error(THREAD_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	/* Write the messages of the files in order, each one once it is done */
+	for(i=0; i < count; i++) {
+		pthread_mutex_lock(&shared.done_lock);
+		while(!shared.jobs[i].done) {
+			pthread_cond_wait(&shared.done_signal, &shared.done_lock);
+		}
+		pthread_mutex_unlock(&shared.done_lock);
+	
+		context_flush(shared.jobs[i].ctx);
+		context_free(shared.jobs[i].ctx);
+	}
+	
+	for(i=0; i < workers; i++) {
+		pthread_join(pool[i].thread, NULL);
+		pthread_mutex_destroy(&shared.queues[i].lock);
+		free(shared.queues[i].jobs);
+	}
+	
+	pthread_mutex_destroy(&shared.done_lock);
+	pthread_cond_destroy(&shared.done_signal);
+	free(pool);
+	free(shared.queues);
+	free(shared.jobs);
+}
+
+/*
+	This function starts a thread for every task but the first, runs the first one on the
+	calling thread and waits for the rest
+*/
+void batch_run(int count, batch_task run, void* data) {
+	task* tasks = (task*)allocate(sizeof(task) * count);
+	int i;
+	
+	for(i=1; i < count; i++) {
+		tasks[i].run = run;
+		tasks[i].data = data;
+		tasks[i].index = i;
+		
+		if(pthread_create(&tasks[i].thread, NULL, run_task, &tasks[i]) != 0) {
+			raise_error(THREAD_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	run(0, data);
+	
+	for(i=1; i < count; i++) {
+		pthread_join(tasks[i].thread, NULL);
+	}
+	
+	free(tasks);
+}
+
+/*
+	This function orders the jobs by size and deals them to the queues in turns,
+	so every queue starts with a large file and the small files are left to be stolen
+*/
+static void deal_jobs(batch* shared) {
+	int count = shared->count;
+	sized_job* order = (sized_job*)allocate(sizeof(sized_job) * count);
+	queue* current;
+	int i;
+	
+	for(i=0; i < count; i++) {
+		order[i].size = shared->jobs[i].size;
+		order[i].index = i;
+	}
+	
+	qsort(order, (size_t)count, sizeof(sized_job), compare_sizes);
+	
+	for(i=0; i < shared->workers; i++) {
+		current = &shared->queues[i];
+		current->jobs = (int*)allocate(sizeof(int) * (count / shared->workers + 1));
+		current->head = 0;
+		current->tail = 0;
+		pthread_mutex_init(&current->lock, NULL);
+	}
+	
+	for(i=0; i < count; i++) {
+		current = &shared->queues[i % shared->workers];
+		current->jobs[current->tail++] = order[i].index;
+	}
+	
+	free(order);
+}
+
+static int compare_sizes(const void* first, const void* second) {
+	const sized_job* a = (const sized_job*)first;
+	const sized_job* b = (const sized_job*)second;
+	
+	if(a->size != b->size) {
+		return (a->size < b->size) ? 1 : -1;
+	}
+	
+	return a->index - b->index;
+}
+
+/*
+	This function assembles jobs until none is left, only the messages of a finished
+	file are kept so the workers never hold more than a file of tables each
+*/
+static void* run_worker(void* argument) {
+	worker* self = (worker*)argument;
+	batch* shared = self->shared;
+	assembler_ctx* ctx;
+	int index;
+	
+	while((index = take_job(shared, self->id)) != INVALID) {
+		ctx = context_new();
+		shared->assemble(ctx, shared->jobs[index].file_name, shared->options);
+		context_free_tables(ctx);
+	
+		pthread_mutex_lock(&shared->done_lock);
+		shared->jobs[index].ctx = ctx;
+		shared->jobs[index].done = TRUE;
+		pthread_cond_broadcast(&shared->done_signal);
+		pthread_mutex_unlock(&shared->done_lock);
+	}
+	
+	return NULL;
+}
+
+/*
+	This function takes the largest job left in the queue of a worker. Once it is empty
+	the smallest job of the next queue that has one is stolen, jobs are never added so
+	a worker that finds every queue empty is done
+*/
+static int take_job(batch* shared, int id) {
+	queue* current;
+	int index = INVALID;
+	int i;
+	
+	current = &shared->queues[id];
+	pthread_mutex_lock(&current->lock);
+	if(current->head < current->tail) {
+		index = current->jobs[current->head++];
+	}
+	pthread_mutex_unlock(&current->lock);
+	
+	for(i=1; i < shared->workers && index == INVALID; i++) {
+		current = &shared->queues[(id + i) % shared->workers];
+		pthread_mutex_lock(&current->lock);
+		if(current->head < current->tail) {
+			index = current->jobs[--current->tail];
+		}
+		pthread_mutex_unlock(&current->lock);
+	}
+	
+	return index;
+}
+
+static void* run_task(void* argument) {
+	task* self = (task*)argument;
+	
+	self->run(self->index, self->data);
+	return NULL;
+}
+
+static long file_size(char* file_name) {
+	char* full_file_name = utils_format_file_name(file_name, ".as");
+	struct stat info;
+	long size = 0;
+	
+	if(stat(full_file_name, &info) == 0) {
+		size = (long)info.st_size;
+	}
+	
+	free(full_file_name);
+	return size;
+}
+
+static void* allocate(size_t size) {
+	void* block = malloc(size > 0 ? size : 1);
+	
+	if(block == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	return block;
+}
\ No newline at end of file
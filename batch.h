@@ -0,0 +1,27 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "context.h"
+
+/* Assembles a single file in a context of its own, with options shared by all files */
+typedef void (*batch_assembler)(assembler_ctx*, char*, void*);
+
+/* Runs a single task of a list by its index, with data shared by all tasks */
+typedef void (*batch_task)(int, void*);
+
+/*
+* This function runs an amount of tasks at once, each on a thread of its own,
+* and returns once all of them are done. The calling thread runs the first task
+*/
+void batch_run(int, batch_task, void*);
+
+/*
+* This function assembles a list of files with a pool of worker threads, each
+* file in a context of its own. Files are started largest first, every worker
+* takes files from a queue of its own and steals from the other queues once it
+* is empty. The messages of each file are written at once in the order of the
+* list, so the output is the same as assembling the files one after another
+*/
+void batch_assemble(char**, int, int, batch_assembler, void*);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "context.h"
+#include "error.h"
+#include "writer.h"
+#include "constants.h"
+#include "line_table.h"
+#include "macro_table.h"
+#include "symbol_table.h"
+#include "fixup_table.h"
+#include "image.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Represents an error or a warning among the messages of a context */
+typedef struct Diagnostic {
+	size_t start; /* Index of the diagnostic in the diagnostics */
+	size_t length; /* Amount of chars of the diagnostic */
+	size_t messages; /* Amount of chars of the messages added before it */
+	int line; /* Line of the diagnostic, INVALID if it belongs to the whole file */
+} diagnostic;
+
+
+/* This function makes room for another diagnostic */
+static diagnostic* add_note(assembler_ctx*);
+/* This function orders the diagnostics added between the same messages by their lines */
+static void sort_notes(assembler_ctx*);
+/* This function compares the lines of two diagnostics, a diagnostic of the whole file comes last */
+static int compare_lines(diagnostic*, diagnostic*);
+/* This function writes an amount of chars to a stream */
+static void write_text(FILE*, char*, size_t);
+
+
+/*
+	This function creates a new context, the tables are initialized by the phases that build them
+*/
+assembler_ctx* context_new() {
+	assembler_ctx* ctx = (assembler_ctx*)malloc(sizeof(assembler_ctx));
+	
+	if(ctx == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	ctx->errors = 0;
+	ctx->dc = 0;
+	ctx->ic = 0;
+	ctx->line_num = 0;
+	
+	ctx->lines = NULL;
+	ctx->macros = NULL;
+	ctx->symbols = NULL;
+	ctx->fixups = NULL;
+	ctx->image = NULL;
+	
+	ctx->messages = writer_buffer_new();
+	ctx->diagnostics = writer_buffer_new();
+	ctx->notes = NULL;
+	ctx->notes_length = 0;
+	ctx->notes_size = 0;
+	return ctx;
+}
+
+/*
+	This function frees a context, every table that was not freed by its phase is freed here
+*/
+void context_free(assembler_ctx* ctx) {
+	if(ctx == NULL) return;
+	
+	context_free_tables(ctx);
+	writer_buffer_free(ctx->messages);
+	writer_buffer_free(ctx->diagnostics);
+	free(ctx->notes);
+	free(ctx);
+}
+
+/*
+	This function frees every table of a context, the messages are kept until they are flushed
+*/
+void context_free_tables(assembler_ctx* ctx) {
+	line_table_free(ctx);
+	macro_table_free(ctx);
+	symbol_table_free(ctx);
+	fixup_table_free(ctx);
+	image_free(ctx);
+}
+
+/*
+	This function appends a progress message to the messages of a context
+*/
+void context_message(assembler_ctx* ctx, const char* message) {
+	writer_buffer_add_string(ctx->messages, message);
+}
+
+/*
+	This function appends a diagnostic and notes how many chars of the messages come before it
+*/
+void context_diagnostic(assembler_ctx* ctx, const char* message, int line) {
+	diagnostic* note = add_note(ctx);
+	
+	note->start = ctx->diagnostics->length;
+	note->messages = ctx->messages->length;
+	note->line = line;
+	
+	writer_buffer_add_string(ctx->diagnostics, message);
+	if(line != INVALID) {
+		writer_buffer_add_string(ctx->diagnostics, " at line: ");
+		writer_buffer_add_int(ctx->diagnostics, line);
+	}
+	writer_buffer_add_char(ctx->diagnostics, '\n');
+	
+	note->length = ctx->diagnostics->length - note->start;
+}
+
+/*
+	This function appends the messages and diagnostics of another context, in the order they were added
+*/
+void context_append(assembler_ctx* ctx, assembler_ctx* source) {
+	diagnostic* note;
+	int i;
+	
+	for(i=0; i < source->notes_length; i++) {
+		note = add_note(ctx);
+		*note = source->notes[i];
+		note->start += ctx->diagnostics->length;
+		note->messages += ctx->messages->length;
+	}
+	
+	memcpy(writer_buffer_reserve(ctx->messages, source->messages->length), source->messages->data, source->messages->length);
+	writer_buffer_advance(ctx->messages, source->messages->length);
+	
+	memcpy(writer_buffer_reserve(ctx->diagnostics, source->diagnostics->length), source->diagnostics->data, source->diagnostics->length);
+	writer_buffer_advance(ctx->diagnostics, source->diagnostics->length);
+}
+
+/*
+	This function writes the messages and diagnostics of a context at once and empties them. Every
+	diagnostic is written after the messages added before it, stdout is flushed before each one so
+	they keep their order when both streams go to one place
+*/
+void context_flush(assembler_ctx* ctx) {
+	size_t written = 0; /* Amount of chars of the messages written */
+	diagnostic* note;
+	int i;
+	
+	sort_notes(ctx);
+	
+	for(i=0; i < ctx->notes_length; i++) {
+		note = &ctx->notes[i];
+		write_text(stdout, ctx->messages->data + written, note->messages - written);
+		written = note->messages;
+		fflush(stdout);
+		write_text(stderr, ctx->diagnostics->data + note->start, note->length);
+	}
+	
+	write_text(stdout, ctx->messages->data + written, ctx->messages->length - written);
+	fflush(stdout);
+	
+	ctx->messages->length = 0;
+	ctx->diagnostics->length = 0;
+	ctx->notes_length = 0;
+}
+
+/*
+	This function returns room for another diagnostic, doubling the notes when they are full
+*/
+static diagnostic* add_note(assembler_ctx* ctx) {
+	if(ctx->notes_length == ctx->notes_size) {
+		ctx->notes_size = (ctx->notes_size == 0) ? TABLE_BASE_SIZE : ctx->notes_size * 2;
+		ctx->notes = (diagnostic*)realloc(ctx->notes, sizeof(diagnostic) * ctx->notes_size);
+		
+		if(ctx->notes == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	return &ctx->notes[ctx->notes_length++];
+}
+
+/*
+	This function sorts every run of diagnostics with no message between them by line, keeping the
+	order of the diagnostics of a line. Labels are resolved after the last line, so the errors they
+	find are placed among the errors of the lines they were found in
+*/
+static void sort_notes(assembler_ctx* ctx) {
+	diagnostic current;
+	int i, j;
+	
+	for(i=1; i < ctx->notes_length; i++) {
+		current = ctx->notes[i];
+		
+		for(j=i; j > 0 && ctx->notes[j-1].messages == current.messages && compare_lines(&ctx->notes[j-1], &current) > 0; j--) {
+			ctx->notes[j] = ctx->notes[j-1];
+		}
+		ctx->notes[j] = current;
+	}
+}
+
+static int compare_lines(diagnostic* first, diagnostic* second) {
+	if(first->line == second->line) return 0;
+	if(first->line == INVALID) return 1;
+	if(second->line == INVALID) return -1;
+	
+	return first->line - second->line;
+}
+
+static void write_text(FILE* stream, char* text, size_t length) {
+	if(length > 0) {
+		fwrite(text, sizeof(char), length, stream);
+	}
+}
\ No newline at end of file
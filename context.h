@@ -0,0 +1,67 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+/*
+* Represents the state of assembling a single file: its counters, every table
+* built for it and the messages it produces. Contexts share nothing, so files
+* can be assembled side by side
+*/
+typedef struct AssemblerContext {
+	int errors; /* Number of errors detected in each one of the assembler phases */
+	int dc; /* Data counter */
+	int ic; /* Instruction counter */
+	int line_num; /* Current line number we are processing */
+	
+	struct LineTable* lines; /* Pre-assembled lines of the file */
+	struct MacroTable* macros; /* Macros of the file, starting with the macro library */
+	struct SymbolTable* symbols; /* Symbols declared in the file */
+	struct FixupTable* fixups; /* Labels resolved once all symbols are declared */
+	struct Image* image; /* Encoded instructions and data */
+	
+	struct OutputBuffer* messages; /* Progress messages, written to stdout once the file is done */
+	struct OutputBuffer* diagnostics; /* Errors and warnings, written to stderr once the file is done */
+	struct Diagnostic* notes; /* Where each diagnostic is placed among the messages, in the order they were added */
+	int notes_length; /* Amount of diagnostics */
+	int notes_size; /* Amount of diagnostics the notes can hold */
+} assembler_ctx;
+
+/*
+* This function creates a new context with no tables and empty messages
+*/
+assembler_ctx* context_new();
+
+/*
+* This function frees a context, its messages and any table it still holds
+*/
+void context_free(assembler_ctx*);
+
+/*
+* This function frees every table a context holds, keeping its messages so a
+* finished file takes little memory until it is flushed
+*/
+void context_free_tables(assembler_ctx*);
+
+/*
+* This function appends a progress message to the messages of a context
+*/
+void context_message(assembler_ctx*, const char*);
+
+/*
+* This function appends an error or a warning to the diagnostics of a context,
+* with its line number unless the line is INVALID
+*/
+void context_diagnostic(assembler_ctx*, const char*, int);
+
+/*
+* This function appends the messages and diagnostics of another context to the
+* ones of a context
+*/
+void context_append(assembler_ctx*, assembler_ctx*);
+
+/*
+* This function writes the messages of a context to stdout and its diagnostics
+* to stderr in the order they were added, and empties them
+*/
+void context_flush(assembler_ctx*);
+
+#endif
\ No newline at end of file
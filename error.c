@@ -1,139 +1,107 @@
-#include "error.h"
-#include "globals.h"
-#include "constants.h"
-#include "utils.h"
-#include <string.h>
-#include <ctype.h>
-	
-
-/*
- * Raises an error and increments the error count.
- */
-void raise_error(const char* message){
-	errors++;
-	fprintf(stderr, "%s\n", message);
-}
-
-/*
- * Raises an error with line number information and increments the error count.
- */
-void raise_error_in_line(const char* message, int line_num) {
-	fprintf(stderr, "%s at line: %d\n", message, line_num);
-    errors++;
-}
-
-/*
- * Raises a warning with line number information.
- */
-void raise_warning_in_line(const char* message, int line_num) {
-    fprintf(stderr, "%s at line: %d\n", message, line_num);
-}
-
-/* Recieves a string and returns TRUE (1) if it is one of the saved keywords in the assembly language
-	returns FALSE (0) otherwise.*/
-int error_invalid_keyword(char* word) {
-	
-	const char* keywords[] = {
-	"@r0", "@r1", "@r2", "@r3", "@r4", "@r5", "@r6", "@r7",
-	"mov", "cmp", "add", "sub", "not", "clr", "lea", "inc", 
-	"dec", "jmp", "bne", "red", "prn", "jsr", "rts", "stop",
-	".entry", ".data", ".string", ".extern"
-	};
-	
-	int i;
-	
-	if (!isalpha(word[0])){
-        raise_error_in_line(INVALID_KEYWORD, line_num);
-        errors++;
-    }
-	
-	for(i=0; i < KEYWORDS_COUNT; i++) {
-		if (!strcmp(word, keywords[i])) {
-			return TRUE;
-		}
-	}
-	return FALSE;
-}
-
-void error_check_instruction(char* line, int is_symbol, char** tokens, int token_count) {
-	/* A constant table of the known commands */
-	const char* keywords[] = {
-	"mov", "cmp", "add", "sub", "not", "clr", "lea", "inc",
-	"dec", "jmp", "bne", "red", "prn","jsr", "rts", "stop"
-	};
-	
-	int i; /* Counter */
-	int command_type = INVALID; /* Type of command, -1 stands for INVALID */
-	int expected_commas = 0;
-	
-	for(i=0; i < AMOUNT_OF_COMMANDS; i++) {
-		if(!strcmp(tokens[is_symbol], keywords[i])) {
-			command_type = i;
-			break;
-		}
-	}
-	
-	if (command_type == -1) {
-		raise_error_in_line(INVALID_COMMAND, line_num);
-		return;
-	}
-	
-	/* All commands with 2 operands */
-	if(command_type <= 3 || command_type == 6) {
-		if (token_count != (is_symbol + 3)) {
-			raise_error_in_line(INVALID_OPERANDS, line_num);
-			return;
-		}
-		
-		expected_commas = 1;
-	}
-	
-	/* All commands with 1 operand */
-	if(command_type == 4 || command_type == 5 || (command_type >=  7 && command_type <= 13)) {
-		if(token_count != (is_symbol + 2)) {
-			raise_error_in_line(INVALID_OPERANDS, line_num);
-			return;
-		}
-	}
-	
-	/* All commands with 0 operands */
-	if(command_type == 14 || command_type == 15) {
-		if(token_count != (is_symbol + 1)) {
-			raise_error_in_line(INVALID_OPERANDS, line_num);
-			return;
-		}
-	}
-	
-	/* Check if valid amount of commas and that there are no consecutive commas */
-	if (!error_check_commas(line, expected_commas)) {
-		raise_error_in_line(INVALID_COMMAS, line_num);
-	}
-}
-
-int error_check_commas(char* line, int expected_commas) {
-	int i;
-	int commas = 0;
-	char* copy = utils_remove_spaces(line); /* Remove spaces & tabs */
-	
-	/* This is an end case, check the last char of the string seperately to avoid mishandling end-cases*/
-	if (copy[strlen(copy) - 1] == ',') {
-		free(copy);
-		return FALSE;
-	}
-	
-	/* Count each comma and check for consecutive commas in line */
-	for(i = 0; i < strlen(copy) - 1; i++) {
-		if (copy[i] == ',') {
-			if(copy[i+1] ==',') {
-				free(copy);
-				return FALSE;
-			}
-			
-			commas++;
-		}
-	}
-	
-	free(copy);
-	return (commas == expected_commas);
-}
-
+#include "error.h"
+#include "constants.h"
+#include "utils.h"
+#include "isa.h"
+#include <string.h>
+#include <ctype.h>
+	
+
+/*
+ * Raises an error that does not belong to a file.
+ */
+void raise_error(const char* message){
+	fprintf(stderr, "%s\n", message);
+}
+
+/*
+ * Raises an error in the file of a context and increments its error count.
+ */
+void raise_error_in_file(assembler_ctx* ctx, const char* message){
+	context_diagnostic(ctx, message, INVALID);
+	ctx->errors++;
+}
+
+/*
+ * Raises an error with line number information and increments the error count.
+ */
+void raise_error_in_line(assembler_ctx* ctx, const char* message, int line_num) {
+	context_diagnostic(ctx, message, line_num);
+    ctx->errors++;
+}
+
+/*
+ * Raises a warning that does not belong to a file.
+ */
+void raise_warning(const char* message) {
+    fprintf(stderr, "%s\n", message);
+}
+
+/*
+ * Raises a warning with line number information.
+ */
+void raise_warning_in_line(assembler_ctx* ctx, const char* message, int line_num) {
+    context_diagnostic(ctx, message, line_num);
+}
+
+/* Recieves a string and returns TRUE (1) if it is one of the saved keywords in the assembly language
+	returns FALSE (0) otherwise.*/
+int error_invalid_keyword(assembler_ctx* ctx, char* word) {
+	if (!isalpha(word[0])){
+        raise_error_in_line(ctx, INVALID_KEYWORD, ctx->line_num);
+        ctx->errors++;
+    }
+	
+	return (scanner_classify_keyword(word, (int)strlen(word)) != KEYWORD_NONE) ? TRUE : FALSE;
+}
+
+int error_check_instruction(assembler_ctx* ctx, scanned_line* scan, int is_symbol) {
+	int command_type = INVALID; /* Type of command, -1 stands for INVALID */
+	int operands; /* Amount of operands the command takes */
+	int token_count = scan->count;
+	
+	/* The scanner already recognized the keyword, commands are numbered by their opcode */
+	if(scan->tokens[is_symbol].word <= KEYWORD_STOP) {
+		command_type = scan->tokens[is_symbol].word;
+	}
+	
+	if (command_type == -1) {
+		raise_error_in_line(ctx, INVALID_COMMAND, ctx->line_num);
+		return FALSE;
+	}
+	
+	/* The command is followed by exactly the operands it takes */
+	operands = isa_get_operands(command_type);
+	if (token_count != (is_symbol + 1 + operands)) {
+		raise_error_in_line(ctx, INVALID_OPERANDS, ctx->line_num);
+		return FALSE;
+	}
+	
+	/* Check if valid amount of commas and that there are no consecutive commas */
+	if (!error_check_commas(scan, (operands > 1) ? operands - 1 : 0)) {
+		raise_error_in_line(ctx, INVALID_COMMAS, ctx->line_num);
+		return FALSE;
+	}
+	
+	return TRUE;
+}
+
+int error_check_commas(scanned_line* scan, int expected_commas) {
+	int i;
+	int commas = 0;
+	
+	/* A comma cannot end the line */
+	if (scan->trailing_commas > 0) {
+		return FALSE;
+	}
+	
+	/* Count each comma and check for consecutive commas between tokens */
+	for(i = 0; i < scan->count; i++) {
+		if (scan->tokens[i].commas > 1) {
+			return FALSE;
+		}
+		
+		commas += scan->tokens[i].commas;
+	}
+	
+	return (commas == expected_commas);
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "fixup_table.h"
+#include "error.h"
+#include "constants.h"
+#include "symbol_table.h"
+#include "translator.h"
+#include "image.h"
+#include <stdlib.h>
+
+
+/* Represents a use of a label that is resolved once all the symbols are declared */
+typedef struct Fixup {
+	int kind; /* Kind of the fixup */
+	int name; /* Name ID of the label, as given by symbol_table_reference */
+	int address; /* Address of the operand word, INVALID if it is not encoded */
+	int line; /* Number of the line the label is used in */
+	const char* error; /* Error raised if an operand label is never declared */
+} fixup;
+
+/* Represents the fixups of a file in the order they were recorded */
+typedef struct FixupTable {
+	struct Fixup* list; /* List of fixups */
+	int current_size; /* Amount of fixups recorded so far */
+	int total_size; /* Total size allocated for the list */
+} fixup_table;
+
+
+/* This function appends a fixup to the table */
+static void append(assembler_ctx*, int, int, int, int, const char*);
+/* This function resolves a label operand */
+static void apply_operand(assembler_ctx*, fixup*);
+/* This function resolves an entry declaration */
+static void apply_entry(assembler_ctx*, fixup*);
+
+
+/*
+	Initialize new fixup table
+*/
+void fixup_table_init(assembler_ctx* ctx) {
+	ctx->fixups = (fixup_table*)malloc(sizeof(fixup_table));
+	
+	if(ctx->fixups == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	ctx->fixups->list = (fixup*)malloc(sizeof(fixup) * TABLE_BASE_SIZE);
+	ctx->fixups->current_size = 0;
+	ctx->fixups->total_size = TABLE_BASE_SIZE;
+	
+	if(ctx->fixups->list == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+}
+
+/*
+	Free the fixup table
+*/
+void fixup_table_free(assembler_ctx* ctx) {
+	if(ctx->fixups == NULL) return;
+	
+	free(ctx->fixups->list);
+	free(ctx->fixups);
+	ctx->fixups = NULL;
+}
+
+/*
+	This function records a label operand, the word at its address is patched once the label is declared
+*/
+void fixup_table_add_operand(assembler_ctx* ctx, int name, int address, int line, const char* error) {
+	append(ctx, FIXUP_OPERAND, name, address, line, error);
+}
+
+/*
+	This function records a label declared as entry, which may be declared as a symbol later in the file
+*/
+void fixup_table_add_entry(assembler_ctx* ctx, int name, int line) {
+	append(ctx, FIXUP_ENTRY, name, INVALID, line, NULL);
+}
+
+/*
+	This function appends the fixups of another context, the operands that are not encoded keep
+	their INVALID address
+*/
+void fixup_table_merge(assembler_ctx* ctx, assembler_ctx* source, int ic) {
+	fixup* current;
+	int i;
+	
+	for(i=0; i < source->fixups->current_size; i++) {
+		current = &source->fixups->list[i];
+		append(ctx, current->kind, symbol_table_reference_from(ctx, source, current->name),
+			(current->address == INVALID) ? INVALID : current->address + ic, current->line, current->error);
+	}
+}
+
+/*
+	This function resolves every fixup in the order they were recorded, so errors are
+	raised and extern uses are recorded in the order of the lines
+*/
+void fixup_table_apply(assembler_ctx* ctx) {
+	int i;
+	
+	for(i=0; i < ctx->fixups->current_size; i++) {
+		if(ctx->fixups->list[i].kind == FIXUP_ENTRY) {
+			apply_entry(ctx, &ctx->fixups->list[i]);
+		} else {
+			apply_operand(ctx, &ctx->fixups->list[i]);
+		}
+	}
+}
+
+/*
+	This function appends a fixup, doubling the list if it is full
+*/
+static void append(assembler_ctx* ctx, int kind, int name, int address, int line, const char* error) {
+	fixup* current;
+	
+	if(ctx->fixups->current_size == ctx->fixups->total_size) {
+		ctx->fixups->total_size *= 2;
+		ctx->fixups->list = (fixup*)realloc(ctx->fixups->list, ctx->fixups->total_size * sizeof(fixup));
+	
+		if(ctx->fixups->list == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	current = &ctx->fixups->list[ctx->fixups->current_size++];
+	current->kind = kind;
+	current->name = name;
+	current->address = address;
+	current->line = line;
+	current->error = error;
+}
+
+/*
+	This function encodes the address of a declared label into its operand word,
+	an undeclared label raises the error of the operand
+*/
+static void apply_operand(assembler_ctx* ctx, fixup* current) {
+	int handle = symbol_table_get_handle(ctx, current->name);
+	
+	if(handle == INVALID) {
+		raise_error_in_line(ctx, current->error, current->line);
+		return;
+	}
+	
+	/* The instruction had an invalid operand, the label is only checked */
+	if(current->address == INVALID) {
+		return;
+	}
+	
+	image_set_word(ctx, current->address, translator_encode_operand(ctx, LABEL, handle, current->address));
+}
+
+/*
+	This function marks a declared label as entry, extern and undeclared labels raise errors
+*/
+static void apply_entry(assembler_ctx* ctx, fixup* current) {
+	int handle = symbol_table_get_handle(ctx, current->name);
+	
+	if(handle != INVALID && symbol_table_get_handle_type(ctx, handle) == EXTERN_TYPE) {
+		raise_error_in_line(ctx, ENTRY_DEFINED_AS_EXTERN, current->line);
+	}
+	
+	if(handle == INVALID) {
+		raise_error_in_line(ctx, ENTRY_NOT_FOUND, current->line);
+		return;
+	}
+	
+	symbol_table_change_to_entry(ctx, handle);
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef FIXUP_TABLE_H
+#define FIXUP_TABLE_H
+
+#include <stddef.h>
+#include "context.h"
+
+/* Kinds of fixups */
+#define FIXUP_OPERAND 0 /* An operand word encoded with the address of a label */
+#define FIXUP_ENTRY 1 /* A label declared as entry */
+
+/*
+* This function initializes the fixup table
+*/
+void fixup_table_init(assembler_ctx*);
+
+/*
+* This function frees the fixup table
+*/
+void fixup_table_free(assembler_ctx*);
+
+/*
+* This function records a label operand by its name ID, the address of its
+* operand word, or INVALID if the instruction is not encoded, the line it is
+* used in and the error raised if the label is never declared
+*/
+void fixup_table_add_operand(assembler_ctx*, int, int, int, const char*);
+
+/*
+* This function records a label declared as entry by its name ID and the line
+* it is declared in
+*/
+void fixup_table_add_entry(assembler_ctx*, int, int);
+
+/*
+* This function appends the fixups of another context in their order, moving
+* the address of each operand word by an amount of instruction words. The names
+* are interned again in the symbol table of the context
+*/
+void fixup_table_merge(assembler_ctx*, assembler_ctx*, int);
+
+/*
+* This function resolves every fixup once all the symbols are declared and
+* their addresses are final, in the order they were recorded. Operand words are
+* patched in the image and every use of an extern symbol is recorded
+*/
+void fixup_table_apply(assembler_ctx*);
+
+#endif
\ No newline at end of file
@@ -1,163 +1,158 @@
-#include "image.h"
-#include "constants.h"
-#include "translator.h"
-#include <string.h>
-#include <stdlib.h>
-
-typedef struct Instruction {
-	int size; /* Size of encoded words of instructions */
-	char** instructions; /* Pointer to encoded words */
-} instruction;
-
-typedef struct Data {
-	int size; /* Size of encoded words of data */
-	char** data; /* Pointer to encoded words */
-} data;
-
-typedef struct Image {
-	struct Instruction** ic_arr; /* List of instruction blocks */
-	int ic_curr_size; /* Size of initialized instructions */
-	int ic_total_size; /* Total size allocated */
-	
-	struct Data** data_arr; /* List of data blocks */
-	int data_curr_size; /* Size of initialized data blocks */
-	int data_total_size; /* Total size allocated */
-} image;
-
-
-image* img; /* Global pointer to the image data structure. */
-
-
-/* Initializes the image data structure for instructions and data. */
-void image_init() {
-	/* Init total image */
-	img = (image*)malloc(sizeof(image));
-	
-	/* Init instructions section */
-	img->ic_arr = (instruction**)malloc(sizeof(instruction*) * TABLE_BASE_SIZE);
-	img->ic_curr_size = 0;
-	img->ic_total_size = TABLE_BASE_SIZE;
-	
-	/* Init data section */
-	img->data_arr = (data**)malloc(sizeof(data*) * TABLE_BASE_SIZE);
-	img->data_curr_size = 0;
-	img->data_total_size = TABLE_BASE_SIZE;
-}
-
-
-/* Frees the memory allocated for the image data structure and its contents. */
-void image_free() {
-	int i, j;
-	
-	if(img == NULL) return;
-	
-	for(i=0; i < img->ic_curr_size; i++) {
-		for(j=0; j < img->ic_arr[i]->size; j++) {
-			free(img->ic_arr[i]->instructions[j]);
-		}
-		free(img->ic_arr[i]->instructions);
-		free(img->ic_arr[i]);
-	}
-	
-	for(i=0; i < img->data_curr_size; i++) {
-		for(j=0; j < img->data_arr[i]->size; j++) {
-			free(img->data_arr[i]->data[j]);
-		}
-		free(img->data_arr[i]->data);
-		free(img->data_arr[i]);
-	}
-	
-	free(img->ic_arr);
-	free(img->data_arr);
-	free(img);
-}
-
-/*
- Prints the contents of the image, including instructions and data.
- For debug purposes 
- */
-
-void image_print() {
-	int i,j;
-	int counter = 0;
-	
-	if(img == NULL) return;
-	
-
-	printf("Printing Image\n\n");
-	for(i=0; i < img->ic_curr_size; i++) {
-		for(j=0; j < img->ic_arr[i]->size; j++) {
-			printf("%d\t%s\n", counter++, img->ic_arr[i]->instructions[j]);
-		}
-	}
-	
-	for(i=0; i < img->data_curr_size; i++) {
-		printf("\nData index: %d\n", i);
-		for(j=0; j < img->data_arr[i]->size; j++) {
-			printf("%d\t%s\n", counter++, img->data_arr[i]->data[j]);
-		}
-	}
-}
-
-/*
-Appends a list of binary instructions to the image's instruction array.
-*/
-
-void image_append_to_instructions(char** coding, int amount_of_lines) {
-	/* Initialize instruction block and assign values */
-	instruction* ic = (instruction*)malloc(sizeof(instruction));
-	ic->size = amount_of_lines;
-	ic->instructions = coding;
-	
-	/* If instruction array is full than reallocate memory */
-	if (img->ic_curr_size == img->ic_total_size) {
-		img->ic_arr = (instruction**)realloc(img->ic_arr, img->ic_total_size + TABLE_BASE_SIZE);
-		img->ic_total_size+= TABLE_BASE_SIZE;
-	}
-	
-	/* Assign instruction to end of instruction array */
-	img->ic_arr[img->ic_curr_size] = ic;
-	img->ic_curr_size++;
-}
-
-/*
- * Appends a list of data values to the image's data array.
- */
-void image_append_to_data(char** coding, int amount_of_lines) {
-	/* Initialize data block and assign values */
-	data* data_node = (data*)malloc(sizeof(data));
-	data_node->size = amount_of_lines;
-	data_node->data = coding;
-	
-	/* Reallocate if data array is full */
-	if(img->data_curr_size == img->data_total_size) {
-		img->data_arr = (data**)realloc(img->data_arr, img->data_total_size + TABLE_BASE_SIZE);
-		img->data_total_size+= TABLE_BASE_SIZE;
-	}
-	
-	/* Assign data to end of data array */
-	img->data_arr[img->data_curr_size] = data_node;
-	img->data_curr_size++;
-}
-
-/*
- * Translates the image's instructions and data into a
- * base64 format and writes it to a file.
- */
-void image_translate(FILE* ob_file) {
-	int i,j;
-	
-	/* For each line of instruction binary word, translate it and write it to final .ob file */
-	for(i=0; i < img->ic_curr_size; i++) {
-		for(j=0; j < img->ic_arr[i]->size; j++) {
-			translator_translate_word(ob_file, img->ic_arr[i]->instructions[j]);
-		}
-	}
-	
-	/* For each of line of binary word of data, translate it and write it to final .ob file*/
-	for(i=0; i < img->data_curr_size; i++) {
-		for(j=0; j < img->data_arr[i]->size; j++) {
-			translator_translate_word(ob_file, img->data_arr[i]->data[j]);
-		}
-	}
+#include "image.h"
+#include "constants.h"
+#include "translator.h"
+#include "error.h"
+#include <string.h>
+#include <stdlib.h>
+
+typedef struct Image {
+	machine_word* words; /* Instruction words followed by data words, indexed by address */
+	int ic_size; /* Amount of instruction words the image has room for */
+	int dc_size; /* Amount of data words the image has room for */
+	int ic_length; /* Amount of instruction words appended */
+	int dc_length; /* Amount of data words appended */
+} image;
+
+
+/*
+ Initializes the image for an amount of instruction words and an amount of data words.
+ Both images are a single block, the data right after the room of the instructions.
+*/
+void image_init(assembler_ctx* ctx, int ic_size, int dc_size) {
+	/* Init total image */
+	ctx->image = (image*)malloc(sizeof(image));
+	
+	if(ctx->image == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	ctx->image->words = (machine_word*)calloc(ic_size + dc_size + 1, sizeof(machine_word));
+	ctx->image->ic_size = ic_size;
+	ctx->image->dc_size = dc_size;
+	ctx->image->ic_length = 0;
+	ctx->image->dc_length = 0;
+	
+	if(ctx->image->words == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+}
+
+
+/* Frees the memory allocated for the image data structure and its contents. */
+void image_free(assembler_ctx* ctx) {
+	if(ctx->image == NULL) return;
+	
+	free(ctx->image->words);
+	free(ctx->image);
+	ctx->image = NULL;
+}
+
+/*
+ Prints the contents of the image, including instructions and data.
+ For debug purposes 
+ */
+
+void image_print(assembler_ctx* ctx) {
+	int i;
+	
+	if(ctx->image == NULL) return;
+	
+
+	printf("Printing Image\n\n");
+	for(i=0; i < ctx->image->ic_length; i++) {
+		printf("%d\t%03X\n", i + MEMORY_OFFSET, ctx->image->words[i]);
+	}
+	
+	printf("\nData\n");
+	for(i=0; i < ctx->image->dc_length; i++) {
+		printf("%d\t%03X\n", i + ctx->image->ic_size + MEMORY_OFFSET, ctx->image->words[ctx->image->ic_size + i]);
+	}
+}
+
+/*
+Appends a list of encoded instruction words to the image's instruction words.
+Words past the room of the image are dropped.
+*/
+
+void image_append_to_instructions(assembler_ctx* ctx, machine_word* coding, int amount_of_lines) {
+	if(ctx->image->ic_length + amount_of_lines > ctx->image->ic_size) {
+		amount_of_lines = ctx->image->ic_size - ctx->image->ic_length;
+	}
+	
+	memcpy(ctx->image->words + ctx->image->ic_length, coding, sizeof(machine_word) * amount_of_lines);
+	ctx->image->ic_length += amount_of_lines;
+}
+
+/*
+ * Appends an encoded data word repeated an amount of times to the image's data words.
+ * Words past the room of the image are dropped.
+ */
+void image_append_to_data(assembler_ctx* ctx, machine_word word, int times) {
+	machine_word* data = ctx->image->words + ctx->image->ic_size + ctx->image->dc_length;
+	int i;
+	
+	if(ctx->image->dc_length + times > ctx->image->dc_size) {
+		times = ctx->image->dc_size - ctx->image->dc_length;
+	}
+	
+	for(i=0; i < times; i++) {
+		data[i] = word;
+	}
+	ctx->image->dc_length += times;
+}
+
+/*
+ * Appends the instruction words of another image after the instruction words, and its
+ * data words after the data words. Words past the room of the image are dropped.
+ */
+void image_merge(assembler_ctx* ctx, assembler_ctx* source) {
+	image* other = source->image;
+	int amount = other->dc_length;
+	
+	image_append_to_instructions(ctx, other->words, other->ic_length);
+	
+	if(ctx->image->dc_length + amount > ctx->image->dc_size) {
+		amount = ctx->image->dc_size - ctx->image->dc_length;
+	}
+	
+	memcpy(ctx->image->words + ctx->image->ic_size + ctx->image->dc_length, other->words + other->ic_size, sizeof(machine_word) * amount);
+	ctx->image->dc_length += amount;
+}
+
+/*
+ * Drops the words appended after an amount of instruction words and an amount of data words,
+ * the words of a line that is left out are written over by the next lines.
+ */
+void image_rewind(assembler_ctx* ctx, int ic_length, int dc_length) {
+	if(ic_length < ctx->image->ic_length) {
+		ctx->image->ic_length = ic_length;
+	}
+	
+	if(dc_length < ctx->image->dc_length) {
+		ctx->image->dc_length = dc_length;
+	}
+}
+
+/*
+ * Replaces the word at a memory address of the image
+ */
+void image_set_word(assembler_ctx* ctx, int address, machine_word word) {
+	ctx->image->words[address - MEMORY_OFFSET] = word;
+}
+
+/*
+ * Translates the image's instructions and data into a
+ * base64 format directly at the end of an output buffer.
+ */
+void image_translate(assembler_ctx* ctx, output_buffer* ob_file) {
+	size_t length;
+	char* records = writer_buffer_reserve(ob_file, (size_t)(ctx->image->ic_length + ctx->image->dc_length) * BASE64_RECORD_SIZE + 1);
+	
+	/* Translate the instruction words, then the data words which start right after the counted instructions */
+	length = translator_translate_words(records, ctx->image->words, ctx->image->ic_length);
+	length += translator_translate_words(records + length, ctx->image->words + ctx->image->ic_size, ctx->image->dc_length);
+	
+	writer_buffer_advance(ob_file, length);
 }
\ No newline at end of file
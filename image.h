@@ -1,35 +1,56 @@
-#ifndef IMAGE_H
-#define IMAGE_H
-#include <stdio.h>
-
-/*
-* Initializes the image data structure for instructions and data
-*/
-void image_init();
-
-/*
-* Frees the memory allocated for the image data structure and its contents
-*/
-void image_free();
-
-/*
-* Prints the contents of the image, including instructions and data
-*/
-void image_print();
-
-/*
-* Appends a list of binary instructions to image's instruction array
-*/
-void image_append_to_instructions(char**, int);
-
-/*
-* Appends a binary encoding of data to image's data array
-*/
-void image_append_to_data(char**, int);
-
-/*
-* Translates image's instructions and data into base 64 format and writes it to file
-*/
-void image_translate(FILE*);
-
+#ifndef IMAGE_H
+#define IMAGE_H
+#include <stdio.h>
+#include "writer.h"
+#include "context.h"
+
+/* Represents an encoded word of the machine, only its lower WORD_SIZE bits are used */
+typedef unsigned short machine_word;
+
+/*
+* Initializes the image data structure for an amount of instruction words and
+* an amount of data words
+*/
+void image_init(assembler_ctx*, int, int);
+
+/*
+* Frees the memory allocated for the image data structure and its contents
+*/
+void image_free(assembler_ctx*);
+
+/*
+* Prints the contents of the image, including instructions and data
+*/
+void image_print(assembler_ctx*);
+
+/*
+* Appends a list of encoded instruction words to image's instruction words
+*/
+void image_append_to_instructions(assembler_ctx*, machine_word*, int);
+
+/*
+* Appends an encoded data word repeated an amount of times to image's data words
+*/
+void image_append_to_data(assembler_ctx*, machine_word, int);
+
+/*
+* Appends the instruction words and the data words of the image of another context
+*/
+void image_merge(assembler_ctx*, assembler_ctx*);
+
+/*
+* Drops the words appended after an amount of instruction words and an amount of data words
+*/
+void image_rewind(assembler_ctx*, int, int);
+
+/*
+* Replaces the encoded word at a memory address of the image
+*/
+void image_set_word(assembler_ctx*, int, machine_word);
+
+/*
+* Translates image's instructions and data into base 64 format and appends it to an output buffer
+*/
+void image_translate(assembler_ctx*, output_buffer*);
+
 #endif
\ No newline at end of file
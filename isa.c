@@ -0,0 +1,37 @@
+#include "isa.h"
+
+/* Tables of the commands by opcode, generated from the instruction set */
+
+#define ISA_COMMAND(mnemonic, name, operands, sources, destinations) operands,
+static const unsigned char operand_counts[AMOUNT_OF_COMMANDS] = { ISA_COMMANDS };
+#undef ISA_COMMAND
+
+#define ISA_COMMAND(mnemonic, name, operands, sources, destinations) sources,
+static const unsigned char source_modes[AMOUNT_OF_COMMANDS] = { ISA_COMMANDS };
+#undef ISA_COMMAND
+
+#define ISA_COMMAND(mnemonic, name, operands, sources, destinations) destinations,
+static const unsigned char destination_modes[AMOUNT_OF_COMMANDS] = { ISA_COMMANDS };
+#undef ISA_COMMAND
+
+
+/*
+	This function returns the amount of operands a command takes
+*/
+int isa_get_operands(int opcode) {
+	return operand_counts[opcode];
+}
+
+/*
+	This function checks the source addressing type of a command against its mask
+*/
+int isa_allows_source(int opcode, int type) {
+	return (source_modes[opcode] >> type) & 1;
+}
+
+/*
+	This function checks the destination addressing type of a command against its mask
+*/
+int isa_allows_destination(int opcode, int type) {
+	return (destination_modes[opcode] >> type) & 1;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef ISA_H
+#define ISA_H
+
+#include "constants.h"
+
+/* Addressing types as bits of a mask, by the number each type is encoded as */
+#define MODE_ABSOLUTE (1 << ABSOLUTE)
+#define MODE_LABEL (1 << LABEL)
+#define MODE_REGISTER (1 << REGISTER)
+#define MODE_NONE 0 /* No operand is taken */
+
+/*
+* The instruction set of the machine, one command per line in the order of their opcodes:
+* ISA_COMMAND(mnemonic, NAME, amount of operands, source addressing types, destination addressing types)
+* Every table about commands is generated from this list.
+*/
+#define ISA_COMMANDS \
+	ISA_COMMAND(mov, MOV, 2, MODE_ABSOLUTE | MODE_LABEL | MODE_REGISTER, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(cmp, CMP, 2, MODE_ABSOLUTE | MODE_LABEL | MODE_REGISTER, MODE_ABSOLUTE | MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(add, ADD, 2, MODE_ABSOLUTE | MODE_LABEL | MODE_REGISTER, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(sub, SUB, 2, MODE_ABSOLUTE | MODE_LABEL | MODE_REGISTER, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(not, NOT, 1, MODE_NONE, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(clr, CLR, 1, MODE_NONE, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(lea, LEA, 2, MODE_LABEL, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(inc, INC, 1, MODE_NONE, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(dec, DEC, 1, MODE_NONE, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(jmp, JMP, 1, MODE_NONE, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(bne, BNE, 1, MODE_NONE, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(red, RED, 1, MODE_NONE, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(prn, PRN, 1, MODE_NONE, MODE_ABSOLUTE | MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(jsr, JSR, 1, MODE_NONE, MODE_LABEL | MODE_REGISTER) \
+	ISA_COMMAND(rts, RTS, 0, MODE_NONE, MODE_NONE) \
+	ISA_COMMAND(stop, STOP, 0, MODE_NONE, MODE_NONE)
+
+/* Opcodes of the commands, the last constant counts the commands of the list */
+#define ISA_COMMAND(mnemonic, name, operands, sources, destinations) OPCODE_##name,
+typedef enum Opcode {
+	ISA_COMMANDS
+	AMOUNT_OF_COMMANDS
+} isa_opcode;
+#undef ISA_COMMAND
+
+/*
+* This function recieves an opcode and returns the amount of operands the command takes
+*/
+int isa_get_operands(int);
+
+/*
+* This function recieves an opcode and an addressing type and returns TRUE if the
+* command takes a source operand of the type, FALSE otherwise
+*/
+int isa_allows_source(int, int);
+
+/*
+* This function recieves an opcode and an addressing type and returns TRUE if the
+* command takes a destination operand of the type, FALSE otherwise
+*/
+int isa_allows_destination(int, int);
+
+#endif
\ No newline at end of file
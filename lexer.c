@@ -1,308 +1,353 @@
-#include "lexer.h"
-#include "symbol_table.h"
-#include "globals.h"
-#include "error.h"
-#include "constants.h"
-#include "image.h"
-#include "writer.h"
-#include "utils.h"
-#include "translator.h"
-#include <string.h>
-#include <stdlib.h>
-
-/* Array of command mnemonics. */
-const char* commands[] = {
-	"mov", "cmp", "add", "sub", "not", "clr", "lea", "inc", "dec", "jmp", "bne", "red", "prn", "jsr", "rts", "stop"
-};
-
-/* Array of register mnemonics. */
-const char* registers[] = {
-	"@r0", "@r1", "@r2", "@r3", "@r4", "@r5", "@r6", "@r7"
-};
-
-/* Binary encodings for different addressing types. */
-const char* addressing_types[] = {
-	"000", "001", "000", "011", "000", "101"
-};
-
-/* Binary encodings for different commands. */
-const char* commands_encoding[] = {
-	"0000", "0001", "0010", "0011", "0100", "0101", "0110", "0111", "1000", "1001", "1010", "1011", "1100", "1101", "1110", "1111"
-};
-
-/* Binary encodings for different registers. */
-const char* register_encoding[] = {
-	"00000", "00001", "00010", "00011", "00100", "00101", "00110", "00111"
-};
-	
-/* This function gets a token and a command_type, and returns the destination type */
-static int get_destination_type(char*, int);
-/* This functions takes in a token and returns the command type */
-static int get_command_type(char*);
-/* This function takes in a token and a command type and returns the source type */
-static int get_source_type(char*, int);
-/* This function takes in a token, returns index to the register array if found, INVALID if not */
-static int get_register(char*);
-
-
-/*
-	This function takes in a line from the input file, analyzes its operands and encodes it to binary representation and appends it to image
-*/
-void lexer_analyze_operation(char** tokens, int token_count, int is_symbol, int amount_of_lines, FILE* ext_file) {
-	int command_type;
-	int source_type;
-	int destination_type;
-	/* Allocate enough memory to hold encoded words in a char arrays */
-	char** coding = (char**)malloc(sizeof(char*) * amount_of_lines);
-	
-	/* Get the type of command */
-	command_type = get_command_type(tokens[is_symbol]);
-	
-	/* If command takes 2 operands, classify both destination and source */
-	if((command_type >= 0 && command_type <= 3) || command_type == 6) {
-		source_type = get_source_type(tokens[is_symbol + 1], command_type);
-		destination_type = get_destination_type(tokens[is_symbol + 2], command_type);
-	}
-	/* If command takes 1 operand, classify operand as destination and assign 0 to source */
-	else if(command_type == 4 || command_type == 5 || (command_type >= 7 && command_type <= 13)) {
-		source_type = 0;
-		destination_type = get_destination_type(tokens[is_symbol + 1], command_type);
-	}
-	/* If command takes no operands, set source and destination to 0 */
-	else {
-		source_type = 0;
-		destination_type = 0;
-	}
-	
-	/* If we recieve -1 on either the source or destination that means it is an invalid operand to the given command */
-	if(source_type == INVALID || destination_type == INVALID) {
-		if(source_type == INVALID){
-			raise_error_in_line(INVALID_SOURCE_OPERAND, line_num);
-		}
-		if(destination_type == INVALID) raise_error_in_line(INVALID_DEST_OPERAND, line_num);
-		free(coding);
-		return;
-	}
-	
-	/* Format binary coding of main command */
-	coding[0] = (char*)calloc(sizeof(char), WORD_SIZE + 1); /* Allocate memory for 12 chars & NULL character */
-	strcpy(coding[0], addressing_types[source_type]);
-	strcat(coding[0], commands_encoding[command_type]);
-	strcat(coding[0], addressing_types[destination_type]);
-	strcat(coding[0], "00");
-	
-	/* Format binary coding of operands depending on source and destination */
-	if(amount_of_lines == 2) {
-		coding[1] = (char*)calloc(sizeof(char), WORD_SIZE + 1);
-
-		/* Both operands are registers*/		
-		if(source_type == REGISTER && destination_type == REGISTER) {
-			strcpy(coding[1], register_encoding[get_register(tokens[is_symbol + 1])]);
-			strcat(coding[1], register_encoding[get_register(tokens[is_symbol + 2])]);
-			strcat(coding[1], "00");
-		}
-		/* Otherwise we are looking at a command with 1 operand so we treat it with destination tpye only */
-		else if(destination_type == REGISTER) {
-			strcpy(coding[1], "00000");
-			strcat(coding[1], register_encoding[get_register(tokens[is_symbol + 1])]);
-			strcat(coding[1], "00");
-		}
-		else{
-			/* If not register encode in different function */
-			translator_encode_operand(coding[1], tokens[is_symbol+1], destination_type, ext_file, 1);
-		}
-	}
-	
-	
-	if(amount_of_lines == 3) {
-		coding[1] = (char*)calloc(sizeof(char), WORD_SIZE + 1);
-		coding[2] = (char*)calloc(sizeof(char), WORD_SIZE + 1);
-		
-		if(source_type == REGISTER) {
-			strcpy(coding[1], register_encoding[get_register(tokens[is_symbol+1])]);
-			strcat(coding[1], "00000");
-			strcat(coding[1], "00");
-		}
-		else {
-			translator_encode_operand(coding[1], tokens[is_symbol+1], source_type, ext_file, 1);
-		}
-		
-		if(destination_type == REGISTER){
-			strcpy(coding[2],"00000");
-			strcat(coding[2], register_encoding[get_register(tokens[is_symbol+2])]);
-			strcat(coding[2], "00");
-		}
-		else{
-			translator_encode_operand(coding[2], tokens[is_symbol+2], destination_type, ext_file, 2);
-		}
-	}
-	
-	image_append_to_instructions(coding, amount_of_lines);
-}
-
-/* 
-This function takes in an array of token, amount of tokens and a flag if line is symbol
-and encodes the data into its binary representation and appends it to the data image
-*/
-void lexer_analyze_data(char** tokens, int token_count, int is_symbol) {
-    int num; /* Converted operand */
-    char** coding; /* Array of binary coding */
-    int size; /* Amount of encoded binary words */
-    int i, index; /* Counters */
-    
-    size = token_count - is_symbol - 1; /* Num of operands = total tokens - label - .data declaration */
-    coding = (char**)malloc(sizeof(char*) * size); /* Allocate memory */
-    
-    for(i= is_symbol + 1, index = 0; i < token_count; i++, index++) {
-		/* Allocate memory for the current binary word */
-        coding[index] = (char*)malloc(sizeof(char) * (WORD_SIZE + 1));
-		/* Convert binary word to an integer */
-        num = atoi(tokens[i]);
-		/* Convert integer to an array of chars representing bits */
-        translator_encode_data(coding[index], num);
-    }
-	
-	/* Append binary encoding to data image */
-	image_append_to_data(coding, size);
-}
-
-/*
-This function recieves a string, analyzes it and encodes it into
-binary representation with the null character
-*/
-void lexer_analyze_string(char* line) {
-    int index, i; /* Counters */
-    char** coding; /* Array of binary coding */
-	int size = 0; /* Amount of encoded binary words */
-	int quotes = 0; /* Amount of quotes detected so far*/
-	
-	/* We first make sure there is a legitimate .string line by counting number of quotes */
-	for(i=0; i < strlen(line); i++) {
-		
-		if(line[i] == '\"') {
-			/* If this is the 3rd double quote we encounter, raise error for invalid string */
-			if(quotes == 2) {
-				raise_error_in_line(INVALID_QUOTES, line_num);
-				return;
-			}
-			quotes++;
-			continue;
-		}
-		
-		/* If 2 > quotes > 0 that means we are inside a string we are supposed to encode */
-		if(quotes == 1)
-			size++;
-	}
-	
-	size++; /* Add size to encode null-character */
-	coding = (char**)malloc(sizeof(char*) * size); /* Allocate memory for each binary word */
-	
-	/* In this loop we encode every character between the double quotes */
-	for(i=0, index=0, quotes=0; i < strlen(line); i++) {
-		if(quotes == 2)
-			break;
-		
-		if(line[i] == '"') {
-			quotes++;
-			continue;
-		}
-		
-		if(quotes == 1) {
-			coding[index] = (char*)malloc(sizeof(char) * (WORD_SIZE+1));
-			translator_encode_char(coding[index], line[i]);
-			index++;
-		}
-	}
-	
-	/* Append null character */
-	coding[size - 1] = utils_duplicate_string("000000000000");
-	image_append_to_data(coding, size);
-}
-
-/*
-This function gets a token and a command_type, and returns the destination type
-*/
-static int get_destination_type(char* token, int command_type) {
-	if(get_register(token) != -1) {
-		return REGISTER;
-	}
-	
-	if(symbol_table_is_symbol_in(token) != -1) {
-		return LABEL;
-	}
-	
-	/* Absolute destination type is only valid for command types 1 and 12 */
-	if(command_type == 1 || command_type == 12) {
-		if(atoi(token) != 0 || !strcmp(token, "0")) {
-			return ABSOLUTE;
-		}
-	}
-
-	return INVALID;
-}
-
-/*
-This functions takes in a token and returns the command type
-*/
-static int get_command_type(char* token) {
-	int i;
-	
-	for(i=0; i < AMOUNT_OF_COMMANDS; i++) {
-		if(!strcmp(token, commands[i])) {
-			return i;
-		}
-	}
-	return INVALID;
-}
-
-/*
-This function takes in a token and a command type and returns the source type
-*/
-static int get_source_type(char* token, int command_type) {
-	int num;
-	
-	/* For command type 6 only label is valid for source type*/
-	if(command_type == 6) {
-		if(symbol_table_is_symbol_in(token)) {
-			return LABEL;
-		}else{
-			raise_error_in_line(INVALID_SOURCE_OPERAND, line_num);
-			return INVALID;
-		}
-	}
-	
-	
-	if(get_register(token) != -1){
-			return REGISTER;
-	}
-	
-		
-	if(symbol_table_is_symbol_in(token) != -1) {
-		return LABEL;
-	}
-		
-	num = atoi(token);
-	if(num || !strcmp(token, "0")) {
-		/* If absolute value cannot be represented by 10 bits raise error */
-		if (num > MAX_NUM_OPERAND || num < MIN_NUM_OPERAND) {
-			return INVALID;
-		} else {
-			return ABSOLUTE;
-		}
-	}
-	return INVALID;
-}
-
-/*
-This function takes in a token, returns index to the register array if found, INVALID if not
-*/
-static int get_register(char* token){
-	int i;
-	
-	for(i=0; i < AMOUNT_OF_REGISTERS; i++) {
-		if(!strcmp(token, registers[i])) {
-			return i;
-		}
-	}
-	return INVALID;
-}
+#include "lexer.h"
+#include "symbol_table.h"
+#include "error.h"
+#include "constants.h"
+#include "image.h"
+#include "writer.h"
+#include "utils.h"
+#include "translator.h"
+#include "scanner.h"
+#include "line_mask.h"
+#include "isa.h"
+#include "fixup_table.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+/* This function gets a token and a command_type, and parses the destination operand */
+static void parse_destination(assembler_ctx*, token*, int, operand*);
+/* This functions takes in a token and returns the command type */
+static int get_command_type(token*);
+/* This function takes in a token and a command type, and parses the source operand */
+static void parse_source(assembler_ctx*, token*, int, operand*);
+/* This function takes in a token, and parses it as a register, an absolute value or a label */
+static void parse_operand(assembler_ctx*, token*, operand*);
+/* This function takes in a token, returns index to the register array if found, INVALID if not */
+static int get_register(token*);
+/* This function encodes a label or absolute operand word, a label is recorded to be patched once it is declared */
+static machine_word encode_operand_word(assembler_ctx*, operand*, int, const char*);
+
+
+/*
+	This function takes in an instruction line from the input file and parses its command and operands.
+	Labels are only interned here, they are resolved by the fixups once all symbols are declared.
+*/
+void lexer_parse_operation(assembler_ctx* ctx, scanned_line* scan, int is_symbol, instruction* ir) {
+	/* Get the type of command */
+	ir->opcode = get_command_type(&scan->tokens[is_symbol]);
+	ir->source.type = NO_OPERAND;
+	ir->source.value = 0;
+	ir->destination.type = NO_OPERAND;
+	ir->destination.value = 0;
+	
+	if(ir->opcode == INVALID) {
+		ir->words = 1;
+		return;
+	}
+	
+	/* If command takes 2 operands, parse both source and destination */
+	if(isa_get_operands(ir->opcode) == 2) {
+		parse_source(ctx, &scan->tokens[is_symbol + 1], ir->opcode, &ir->source);
+		parse_destination(ctx, &scan->tokens[is_symbol + 2], ir->opcode, &ir->destination);
+	}
+	/* If command takes 1 operand, parse operand as destination */
+	else if(isa_get_operands(ir->opcode) == 1) {
+		parse_destination(ctx, &scan->tokens[is_symbol + 1], ir->opcode, &ir->destination);
+	}
+	
+	ir->words = lexer_count_words(scan, is_symbol);
+}
+
+/*
+	This function calculates the amount of words an instruction line is encoded to, by the operands
+	its command takes. It needs no symbols, so macro bodies can be measured before the assembly pass.
+*/
+int lexer_count_words(scanned_line* scan, int is_symbol) {
+	int command_type = get_command_type(&scan->tokens[is_symbol]);
+	
+	if(command_type == INVALID) {
+		return 1;
+	}
+	
+	/* Two operands take a word each, unless both are registers and share one */
+	if(isa_get_operands(command_type) == 2 && get_register(&scan->tokens[is_symbol + 1]) != INVALID &&
+		get_register(&scan->tokens[is_symbol + 2]) != INVALID) {
+		return 2;
+	}
+	
+	/* Otherwise one word for the command and one for each operand */
+	return 1 + isa_get_operands(command_type);
+}
+
+/*
+	This function takes in a parsed instruction, encodes it to binary representation and appends it to image
+*/
+void lexer_analyze_operation(assembler_ctx* ctx, instruction* ir) {
+	int next = 1; /* Index of the next operand word */
+	machine_word coding[MAX_OPERANDS + 1]; /* Encoded words, one for the command and at most one per operand */
+	
+	/* An unknown command was already reported */
+	if(ir->opcode == INVALID) {
+		return;
+	}
+	
+	/* If we recieve -1 on either the source or destination that means it is an invalid operand to the given command */
+	if(ir->source.type == INVALID || ir->destination.type == INVALID) {
+		if(ir->source.type == INVALID){
+			raise_error_in_line(ctx, INVALID_SOURCE_OPERAND, ctx->line_num);
+		}
+		if(ir->destination.type == INVALID) raise_error_in_line(ctx, INVALID_DEST_OPERAND, ctx->line_num);
+		
+		/* The instruction is not encoded, but a label of the other operand must still be declared */
+		if(ir->source.type == LABEL) fixup_table_add_operand(ctx, ir->source.value, INVALID, ctx->line_num, INVALID_SOURCE_OPERAND);
+		if(ir->destination.type == LABEL) fixup_table_add_operand(ctx, ir->destination.value, INVALID, ctx->line_num, INVALID_DEST_OPERAND);
+		return;
+	}
+	
+	/* Encode the main command, addressing types are numbered by their encoding */
+	coding[0] = translator_encode_command(ir->opcode, ir->source.type, ir->destination.type);
+	
+	/* Both operands are registers, they share a single word */
+	if(ir->source.type == REGISTER && ir->destination.type == REGISTER) {
+		coding[1] = translator_encode_registers(ir->source.value, ir->destination.value);
+		image_append_to_instructions(ctx, coding, ir->words);
+		return;
+	}
+	
+	if(ir->source.type != NO_OPERAND) {
+		if(ir->source.type == REGISTER) {
+			coding[next] = translator_encode_registers(ir->source.value, INVALID);
+		} else {
+			coding[next] = encode_operand_word(ctx, &ir->source, MEMORY_OFFSET + ctx->ic + next, INVALID_SOURCE_OPERAND);
+		}
+		next++;
+	}
+	
+	if(ir->destination.type != NO_OPERAND) {
+		if(ir->destination.type == REGISTER) {
+			coding[next] = translator_encode_registers(INVALID, ir->destination.value);
+		} else {
+			coding[next] = encode_operand_word(ctx, &ir->destination, MEMORY_OFFSET + ctx->ic + next, INVALID_DEST_OPERAND);
+		}
+	}
+	
+	image_append_to_instructions(ctx, coding, ir->words);
+}
+
+
+/*
+This function reads the next value of a .data declaration. A value followed by the repeat
+operator and a count stands for the value repeated count times, otherwise it appears once.
+*/
+int lexer_next_data_value(char** values, data_value* current) {
+    char* text; /* Current token */
+    size_t length; /* Length of the current token */
+    
+    text = utils_next_token(*values, DATA_DELIMITERS, &length);
+    if(text == NULL)
+        return FALSE;
+    
+    /* The value ends at a delimiter */
+    current->value = atoi(text);
+    current->valid = (current->value || (length == 1 && text[0] == '0'));
+    current->times = 1;
+    *values = text + length;
+    
+    /* Check for the repeat form */
+    text = utils_next_token(*values, DATA_DELIMITERS, &length);
+    if(text != NULL && length == 1 && text[0] == REPEAT_OPERATOR) {
+        *values = text + length;
+        text = utils_next_token(*values, DATA_DELIMITERS, &length);
+        
+        if(text == NULL) {
+            current->times = INVALID;
+            return TRUE;
+        }
+        
+        current->times = utils_parse_count(text, length);
+        *values = text + length;
+    }
+    
+    return TRUE;
+}
+
+/* 
+This function takes in the values of a .data declaration, the text after the directive,
+and encodes each value straight from the line into its binary representation, appending
+them to the data image as many times as they are repeated. Returns the amount of words appended.
+*/
+int lexer_analyze_data(assembler_ctx* ctx, char* values) {
+    int counter = 0; /* Amount of words appended */
+    data_value current; /* Current value */
+    
+    while(lexer_next_data_value(&values, &current)) {
+        if(current.times == INVALID) {
+            raise_error_in_line(ctx, INVALID_REPEAT, ctx->line_num);
+            continue;
+        }
+        
+        /* Values that are not integers are left out */
+        if(!current.valid)
+            continue;
+        
+        image_append_to_data(ctx, translator_encode_data(ctx, current.value), current.times);
+        counter += current.times;
+    }
+    
+    /* If no valid integers met, raise error */
+    if(counter == 0) {
+        raise_error_in_line(ctx, INVALID_DATA, ctx->line_num);
+    }
+    
+    return counter;
+}
+
+/*
+This function takes in the size of a .space declaration and appends that many zero
+words to the data image, returns the amount of words reserved
+*/
+int lexer_analyze_space(assembler_ctx* ctx, char* values) {
+    char* count; /* The size */
+    size_t length, rest_length; /* Length of the size and of a token after it */
+    int size = INVALID; /* Amount of reserved words */
+    
+    /* The count must be the only token after the directive */
+    count = utils_next_token(values, DATA_DELIMITERS, &length);
+    if(count != NULL && utils_next_token(count + length, DATA_DELIMITERS, &rest_length) == NULL) {
+        size = utils_parse_count(count, length);
+    }
+    
+    if(size == INVALID) {
+        raise_error_in_line(ctx, INVALID_SPACE, ctx->line_num);
+        return 0;
+    }
+    
+    image_append_to_data(ctx, 0, size);
+    return size;
+}
+
+/*
+This function recieves a string, analyzes it and encodes it into
+binary representation with the null character, returns the amount of words appended
+*/
+int lexer_analyze_string(assembler_ctx* ctx, char* line) {
+    int i; /* Counter */
+	int first, second, third; /* Positions of the first 3 quotes */
+	line_mask mask; /* Positions of the quotes in the line */
+	
+	/* We first make sure there is a legitimate .string line by finding the quotes */
+	line_mask_build(&mask, line);
+	first = line_mask_next(&mask, mask.quotes, 0);
+	second = line_mask_next(&mask, mask.quotes, first + 1);
+	third = line_mask_next(&mask, mask.quotes, second + 1);
+	line_mask_free(&mask);
+	
+	/* If there is a 3rd double quote, raise error for invalid string */
+	if(third < mask.length) {
+		raise_error_in_line(ctx, INVALID_QUOTES, ctx->line_num);
+		return 0;
+	}
+	
+	/* Every char between the quotes is encoded, up to the end of the line if the string is not closed */
+	if(first < mask.length) {
+		for(i=first + 1; i < second; i++) {
+			image_append_to_data(ctx, translator_encode_char(line[i]), 1);
+		}
+	}
+	
+	/* Append null character */
+	image_append_to_data(ctx, 0, 1);
+	
+	/* The chars between the quotes and the null character */
+	return (first < mask.length) ? second - first : 1;
+}
+
+/*
+This function gets a token and a command_type, and parses the destination operand
+*/
+static void parse_destination(assembler_ctx* ctx, token* current, int command_type, operand* result) {
+	parse_operand(ctx, current, result);
+	
+	/* The addressing type must be one the command takes */
+	if(result->type != INVALID && !isa_allows_destination(command_type, result->type)) {
+		result->type = INVALID;
+	}
+}
+
+/*
+This functions takes in a token and returns the command type
+*/
+static int get_command_type(token* operation) {
+	/* Commands are numbered by their opcode */
+	if(operation->word >= KEYWORD_MOV && operation->word <= KEYWORD_STOP) {
+		return operation->word;
+	}
+	return INVALID;
+}
+
+/*
+This function takes in a token and a command type, and parses the source operand
+*/
+static void parse_source(assembler_ctx* ctx, token* current, int command_type, operand* result) {
+	parse_operand(ctx, current, result);
+	
+	/* The addressing type must be one the command takes */
+	if(result->type != INVALID && !isa_allows_source(command_type, result->type)) {
+		result->type = INVALID;
+	}
+	
+	/* If absolute value cannot be represented by 10 bits it is invalid */
+	if(result->type == ABSOLUTE && (result->value > MAX_NUM_OPERAND || result->value < MIN_NUM_OPERAND)) {
+		result->type = INVALID;
+	}
+}
+
+/*
+This function takes in a token, and parses it as a register, an absolute value, or otherwise a label.
+A name that does not start with a letter can never be declared as a label, so it is left invalid.
+*/
+static void parse_operand(assembler_ctx* ctx, token* current, operand* result) {
+	result->value = get_register(current);
+	if(result->value != INVALID) {
+		result->type = REGISTER;
+		return;
+	}
+	
+	result->value = atoi(current->text);
+	if(result->value || !strcmp(current->text, "0")) {
+		result->type = ABSOLUTE;
+		return;
+	}
+	
+	if(!isalpha(current->text[0])) {
+		result->type = INVALID;
+		return;
+	}
+	
+	result->type = LABEL;
+	result->value = symbol_table_reference(ctx, current->text, (size_t)current->length);
+}
+
+/*
+This function takes in a token, returns index to the register array if found, INVALID if not
+*/
+static int get_register(token* operand){
+	/* The scanner already recognized @r0 to @r7 */
+	if(operand->word >= KEYWORD_R0 && operand->word <= KEYWORD_R7) {
+		return operand->word - KEYWORD_R0;
+	}
+	return INVALID;
+}
+
+/*
+This function encodes a label or absolute operand word at an address. The address of a label
+is not known until all symbols are declared, so its word is recorded to be patched later.
+*/
+static machine_word encode_operand_word(assembler_ctx* ctx, operand* current, int address, const char* error) {
+	if(current->type == LABEL) {
+		fixup_table_add_operand(ctx, current->value, address, ctx->line_num, error);
+		return 0;
+	}
+	
+	return translator_encode_operand(ctx, current->type, current->value, address);
+}
\ No newline at end of file
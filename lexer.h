@@ -1,22 +1,74 @@
-#ifndef LEXER_H
-#define LEXER_H
-#include <stdio.h>
-
-/*
-* This function takes in a line from the input file, analyzes its operands
-* and encodes it to binary representation
-*/
-void lexer_analyze_operation(char**, int, int, int, FILE*);
-
-/*
-* This function encodes data into binary representation and appends it
-* to the data image
-*/
-void lexer_analyze_data(char**, int, int);
-
-/*
-* This function recieves a string , analyzes it and encodes it into binary_functio
-*/
-void lexer_analyze_string(char*);
-
+#ifndef LEXER_H
+#define LEXER_H
+#include <stdio.h>
+#include "scanner.h"
+#include "context.h"
+
+#define REPEAT_OPERATOR '*' /* Separates a .data value from its repeat count, as in '.data 0 * 100', it cannot start a label */
+#define NO_OPERAND 0 /* Addressing type of an operand a command does not take */
+
+/* Represents an operand of an instruction, parsed once by the assembly pass */
+typedef struct Operand {
+	int type; /* Addressing type, ABSOLUTE, LABEL, REGISTER or NO_OPERAND, INVALID if not valid for the command */
+	int value; /* Register index, absolute value, or name ID of the label as given by symbol_table_reference */
+} operand;
+
+/* Represents an instruction line, parsed once and encoded from by the assembly pass */
+typedef struct Instruction {
+	int opcode; /* Command type, INVALID if the command is unknown */
+	operand source;
+	operand destination;
+	int words; /* Amount of words the instruction is encoded to */
+} instruction;
+
+/* Represents a value of a .data declaration and the amount of times it is repeated */
+typedef struct DataValue {
+	int value; /* Converted value */
+	int valid; /* Flag if the value is an integer */
+	int times; /* Amount of times the value is repeated, INVALID if the repeat count is invalid */
+} data_value;
+
+/*
+* This function takes in an instruction line from the input file and parses its
+* command and operands into an instruction
+*/
+void lexer_parse_operation(assembler_ctx*, scanned_line*, int, instruction*);
+
+/*
+* This function takes in an instruction line from the input file and returns the
+* amount of words it is encoded to
+*/
+int lexer_count_words(scanned_line*, int);
+
+/*
+* This function takes in a parsed instruction and encodes it to binary
+* representation at the current ic, label operands are recorded as fixups
+*/
+void lexer_analyze_operation(assembler_ctx*, instruction*);
+
+/*
+* This function encodes the values of a .data declaration, read straight from
+* the line, into binary representation and appends them to the data image.
+* Returns the amount of words appended
+*/
+int lexer_analyze_data(assembler_ctx*, char*);
+
+/*
+* This function reads the next value of a .data declaration and its repeat count,
+* advancing the given text past them. Returns FALSE if there are no more values
+*/
+int lexer_next_data_value(char**, data_value*);
+
+/*
+* This function reserves the words of a .space declaration by appending that many
+* zero words to the data image. Returns the amount of words reserved
+*/
+int lexer_analyze_space(assembler_ctx*, char*);
+
+/*
+* This function recieves a string , analyzes it and encodes it into binary_functio
+* Returns the amount of words appended
+*/
+int lexer_analyze_string(assembler_ctx*, char*);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "line_mask.h"
+#include "error.h"
+#include <string.h>
+#include <stdlib.h>
+
+/* SIMD kernels are built for x86 compilers which support target attributes */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define LINE_MASK_SIMD
+#include <immintrin.h>
+#endif
+
+#define LOW_BITS 0xFFFFFFFFUL
+
+/* This function chooses the fastest kernel the CPU supports */
+static void choose_kernel();
+/* This function builds a word of each mask one char at a time */
+static void scalar_kernel(const unsigned char*, unsigned long*, unsigned long*, unsigned long*);
+/* This function returns the index of the lowest set bit of a non zero word */
+static int lowest_bit(unsigned long);
+/* This function counts the set bits of a word */
+static int count_bits(unsigned long);
+
+#ifdef LINE_MASK_SIMD
+/* This function builds a word of each mask 16 chars at a time */
+static void sse2_kernel(const unsigned char*, unsigned long*, unsigned long*, unsigned long*) __attribute__((target("sse2")));
+/* This function builds a word of each mask 32 chars at a time */
+static void avx2_kernel(const unsigned char*, unsigned long*, unsigned long*, unsigned long*) __attribute__((target("avx2")));
+#endif
+
+/* Kernel used to build masks, chosen by line_mask_init or on first use */
+static void (*kernel)(const unsigned char*, unsigned long*, unsigned long*, unsigned long*) = NULL;
+
+
+/*
+	This function chooses the kernel before the first line is masked instead of on it
+*/
+void line_mask_init() {
+	if(kernel == NULL) choose_kernel();
+}
+
+/*
+	This function builds the masks of a line, a word of each mask for every 32
+	chars. The kernels read whole blocks of 32 chars, so the last block is copied
+	to a zero padded block first.
+*/
+void line_mask_build(line_mask* mask, char* line) {
+	unsigned char block[MASK_BITS];
+	size_t length = strlen(line);
+	int full = (int)(length / MASK_BITS); /* Amount of whole blocks */
+	int i;
+	
+	if(kernel == NULL) choose_kernel();
+	
+	mask->length = (int)length;
+	mask->words = full + 1;
+	mask->allocated = NULL;
+	
+	/* Short lines use the storage inside the mask */
+	if(mask->words <= MASK_WORDS) {
+		mask->quotes = mask->storage;
+	} else {
+		mask->allocated = (unsigned long*)malloc(sizeof(unsigned long) * 4 * mask->words);
+		
+		if(mask->allocated == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+		mask->quotes = mask->allocated;
+	}
+	mask->commas = mask->quotes + mask->words;
+	mask->spaces = mask->commas + mask->words;
+	mask->delimiters = mask->spaces + mask->words;
+	
+	for(i=0; i < full; i++) {
+		kernel((const unsigned char*)line + i * MASK_BITS, &mask->quotes[i], &mask->commas[i], &mask->spaces[i]);
+	}
+	
+	memcpy(block, line + full * MASK_BITS, length - full * MASK_BITS);
+	memset(block + (length - full * MASK_BITS), 0, MASK_BITS - (length - full * MASK_BITS));
+	kernel(block, &mask->quotes[full], &mask->commas[full], &mask->spaces[full]);
+	
+	for(i=0; i < mask->words; i++) {
+		mask->delimiters[i] = mask->spaces[i] | mask->commas[i];
+	}
+}
+
+/*
+	This function frees the masks of a long line
+*/
+void line_mask_free(line_mask* mask) {
+	if(mask->allocated != NULL) {
+		free(mask->allocated);
+		mask->allocated = NULL;
+	}
+}
+
+/*
+	This function finds the first set bit at or after a position, skipping whole
+	words of clear bits
+*/
+int line_mask_next(line_mask* mask, unsigned long* bits, int from) {
+	int word = from / MASK_BITS;
+	unsigned long current;
+	
+	if(from >= mask->length) return mask->length;
+	
+	/* Ignore the bits before the position in its word */
+	current = bits[word] & ((LOW_BITS << (from % MASK_BITS)) & LOW_BITS);
+	
+	while(current == 0) {
+		if(++word == mask->words) return mask->length;
+		current = bits[word];
+	}
+	
+	from = word * MASK_BITS + lowest_bit(current);
+	return (from < mask->length) ? from : mask->length;
+}
+
+/*
+	This function finds the first clear bit at or after a position
+*/
+int line_mask_next_clear(line_mask* mask, unsigned long* bits, int from) {
+	int word = from / MASK_BITS;
+	unsigned long current;
+	
+	if(from >= mask->length) return mask->length;
+	
+	/* Invert the word so clear bits become set, ignoring the bits before the position */
+	current = ~bits[word] & ((LOW_BITS << (from % MASK_BITS)) & LOW_BITS);
+	
+	while(current == 0) {
+		if(++word == mask->words) return mask->length;
+		current = ~bits[word] & LOW_BITS;
+	}
+	
+	from = word * MASK_BITS + lowest_bit(current);
+	return (from < mask->length) ? from : mask->length;
+}
+
+/*
+	This function counts the set bits in a range of positions
+*/
+int line_mask_count(unsigned long* bits, int from, int to) {
+	int count = 0;
+	int word;
+	unsigned long current;
+	
+	for(word = from / MASK_BITS; word * MASK_BITS < to; word++) {
+		current = bits[word];
+		
+		/* Clear the bits outside of the range */
+		if(word == from / MASK_BITS) current &= (LOW_BITS << (from % MASK_BITS)) & LOW_BITS;
+		if(word == to / MASK_BITS) current &= ~(LOW_BITS << (to % MASK_BITS)) & LOW_BITS;
+		
+		count += count_bits(current);
+	}
+	
+	return count;
+}
+
+/*
+This function chooses the kernel by the features of the CPU, the scalar one
+is used on other architectures
+*/
+static void choose_kernel() {
+	kernel = scalar_kernel;
+	
+#ifdef LINE_MASK_SIMD
+	__builtin_cpu_init();
+	
+	if(__builtin_cpu_supports("avx2")) {
+		kernel = avx2_kernel;
+	} else if(__builtin_cpu_supports("sse2")) {
+		kernel = sse2_kernel;
+	}
+#endif
+}
+
+/*
+This function builds a word of each mask by testing each char of a block
+*/
+static void scalar_kernel(const unsigned char* block, unsigned long* quotes, unsigned long* commas, unsigned long* spaces) {
+	int i;
+	
+	*quotes = 0;
+	*commas = 0;
+	*spaces = 0;
+	
+	for(i=0; i < MASK_BITS; i++) {
+		switch(block[i]) {
+			case '"': *quotes |= 1UL << i; break;
+			case ',': *commas |= 1UL << i; break;
+			case ' ': case '\t': case '\n': case '\r': *spaces |= 1UL << i; break;
+		}
+	}
+}
+
+#ifdef LINE_MASK_SIMD
+/*
+This function compares 16 chars at a time with each interesting char, the 2
+halves of a block fill the low and high halves of each word
+*/
+static void sse2_kernel(const unsigned char* block, unsigned long* quotes, unsigned long* commas, unsigned long* spaces) {
+	int half;
+	__m128i chars, blanks;
+	
+	*quotes = 0;
+	*commas = 0;
+	*spaces = 0;
+	
+	for(half=0; half < 2; half++) {
+		chars = _mm_loadu_si128((const __m128i*)(block + half * 16));
+		
+		blanks = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('\r'))));
+		
+		*quotes |= (unsigned long)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('"'))) << (half * 16);
+		*commas |= (unsigned long)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(','))) << (half * 16);
+		*spaces |= (unsigned long)_mm_movemask_epi8(blanks) << (half * 16);
+	}
+}
+
+/*
+This function compares 32 chars at a time with each interesting char
+*/
+static void avx2_kernel(const unsigned char* block, unsigned long* quotes, unsigned long* commas, unsigned long* spaces) {
+	__m256i chars, blanks;
+	
+	chars = _mm256_loadu_si256((const __m256i*)block);
+	
+	blanks = _mm256_or_si256(
+		_mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\t'))),
+		_mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\r'))));
+	
+	/* The movemask is a signed int, keep its 32 bits only */
+	*quotes = (unsigned long)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('"')));
+	*commas = (unsigned long)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(',')));
+	*spaces = (unsigned long)(unsigned int)_mm256_movemask_epi8(blanks);
+}
+#endif
+
+/*
+This function returns the index of the lowest set bit of a non zero word
+*/
+static int lowest_bit(unsigned long bits) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzl(bits);
+#else
+	int index = 0;
+	
+	while(!(bits & 1UL)) {
+		bits >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+/*
+This function counts the set bits of a word
+*/
+static int count_bits(unsigned long bits) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountl(bits);
+#else
+	int count = 0;
+	
+	while(bits) {
+		bits &= bits - 1;
+		count++;
+	}
+	return count;
+#endif
+}
\ No newline at end of file
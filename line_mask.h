@@ -0,0 +1,58 @@
+#ifndef LINE_MASK_H
+#define LINE_MASK_H
+
+#include "constants.h"
+
+#define MASK_BITS 32 /* Chars covered by each word of a mask, the low bits of an unsigned long */
+#define MASK_WORDS ((MAX_LINE_LENGTH * 2 + MASK_BITS - 1) / MASK_BITS) /* Words of the masks kept without allocation */
+
+/* Represents the positions of interesting chars in a line, bit i stands for char i */
+typedef struct LineMask {
+	unsigned long* quotes; /* Double quotes */
+	unsigned long* commas; /* Commas */
+	unsigned long* spaces; /* Spaces, tabs, new lines and carriage returns */
+	unsigned long* delimiters; /* Spaces and commas, the chars between tokens */
+	int length; /* Amount of chars in the line */
+	int words; /* Amount of words in each mask */
+	
+	unsigned long storage[4 * MASK_WORDS]; /* Masks of short lines */
+	unsigned long* allocated; /* Masks of long lines, NULL if storage is used */
+} line_mask;
+
+/*
+* This function chooses the kernel of line_mask_build ahead of time, so lines
+* can be masked by several threads at once
+*/
+void line_mask_init();
+
+/*
+* This function builds the masks of a line of any length, SIMD kernels are used
+* when the CPU supports them. Masks of long lines are allocated, and need to be
+* freed by line_mask_free.
+*/
+void line_mask_build(line_mask*, char*);
+
+/*
+* This function frees the masks of a line, if they were allocated
+*/
+void line_mask_free(line_mask*);
+
+/*
+* This function returns the position of the first set bit of a mask at or after
+* a position, or the length of the line if there is none
+*/
+int line_mask_next(line_mask*, unsigned long*, int);
+
+/*
+* This function returns the position of the first clear bit of a mask at or
+* after a position, or the length of the line if there is none
+*/
+int line_mask_next_clear(line_mask*, unsigned long*, int);
+
+/*
+* This function counts the set bits of a mask from a position up to, but not
+* including, another position
+*/
+int line_mask_count(unsigned long*, int, int);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "line_table.h"
+#include "error.h"
+#include "constants.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Represents the pre-assembled source, the contents of a .am file kept in memory */
+typedef struct LineTable {
+	char* text; /* Every line followed by a null character */
+	size_t text_length; /* Amount of chars used in text */
+	size_t text_capacity; /* Amount of chars allocated for text */
+	
+	size_t* offsets; /* Offset in text of each line */
+	int current_size; /* Amount of lines in the table */
+	int total_size; /* Amount of offsets allocated */
+	
+	int line_open; /* Flag if the last line has not been ended with a new line yet */
+} line_table;
+
+
+/* Offset of a line marked for removal */
+#define REMOVED_LINE ((size_t)-1)
+
+/* This function makes sure text can hold an amount of extra chars */
+static void reserve_text(assembler_ctx*, size_t);
+/* This function starts a new line at the end of text */
+static void open_line(assembler_ctx*);
+
+
+/*
+	This function initializes the line table
+*/
+void line_table_init(assembler_ctx* ctx) {
+	ctx->lines = (line_table*)malloc(sizeof(line_table));
+	
+	if(ctx->lines == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	ctx->lines->text = (char*)malloc(sizeof(char) * MAX_LINE_LENGTH * TABLE_BASE_SIZE);
+	ctx->lines->text_length = 0;
+	ctx->lines->text_capacity = MAX_LINE_LENGTH * TABLE_BASE_SIZE;
+	
+	ctx->lines->offsets = (size_t*)malloc(sizeof(size_t) * TABLE_BASE_SIZE);
+	ctx->lines->current_size = 0;
+	ctx->lines->total_size = TABLE_BASE_SIZE;
+	
+	ctx->lines->line_open = FALSE;
+	
+	if(ctx->lines->text == NULL || ctx->lines->offsets == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+}
+
+/*
+	This function frees the line table
+*/
+void line_table_free(assembler_ctx* ctx) {
+	if(ctx->lines == NULL) return;
+	
+	free(ctx->lines->text);
+	free(ctx->lines->offsets);
+	free(ctx->lines);
+	ctx->lines = NULL;
+}
+
+/*
+	This function appends text to the table. Every new line character ends the
+	current line, text after the last new line is continued by the next append.
+*/
+void line_table_append(assembler_ctx* ctx, char* source, size_t length) {
+	size_t i;
+	
+	/* Each line needs one extra char for its null character */
+	reserve_text(ctx, length * 2);
+	
+	for(i=0; i < length; i++) {
+		if(!ctx->lines->line_open) {
+			open_line(ctx);
+		}
+		
+		ctx->lines->text[ctx->lines->text_length++] = source[i];
+		
+		/* End the line with a null character right after its new line */
+		if(source[i] == '\n') {
+			ctx->lines->text[ctx->lines->text_length++] = '\0';
+			ctx->lines->line_open = FALSE;
+		}
+	}
+}
+
+/*
+	This function appends a line with each of its tokens followed by a single
+	space, the same way they were written to the .am file. The tokens are
+	copied straight into the table without any allocation.
+*/
+void line_table_append_normalized(assembler_ctx* ctx, char* source, const char* delim) {
+	/* Each token gains at most one space, plus the new line and null characters */
+	reserve_text(ctx, strlen(source) + 3);
+	open_line(ctx);
+	
+	ctx->lines->text_length += utils_normalize_spaces(ctx->lines->text + ctx->lines->text_length, source, delim, TRUE);
+	ctx->lines->text[ctx->lines->text_length++] = '\n';
+	ctx->lines->text[ctx->lines->text_length++] = '\0';
+	ctx->lines->line_open = FALSE;
+}
+
+/*
+	This function returns the amount of lines in the table
+*/
+int line_table_get_length(assembler_ctx* ctx) {
+	return ctx->lines->current_size;
+}
+
+/*
+	This function returns the line at the index
+*/
+char* line_table_get_line(assembler_ctx* ctx, int index) {
+	return ctx->lines->text + ctx->lines->offsets[index];
+}
+
+/*
+	This function replaces the line at the index. The new line is appended to
+	the end of text, the space of the old one is not reused.
+*/
+void line_table_set_line(assembler_ctx* ctx, int index, char* source) {
+	size_t length = strlen(source);
+	
+	reserve_text(ctx, length + 2);
+	ctx->lines->offsets[index] = ctx->lines->text_length;
+	
+	memcpy(ctx->lines->text + ctx->lines->text_length, source, length);
+	ctx->lines->text_length += length;
+	ctx->lines->text[ctx->lines->text_length++] = '\n';
+	ctx->lines->text[ctx->lines->text_length++] = '\0';
+}
+
+/*
+	This function marks the line at the index for removal
+*/
+void line_table_remove_line(assembler_ctx* ctx, int index) {
+	ctx->lines->offsets[index] = REMOVED_LINE;
+}
+
+/*
+	This function removes every line marked for removal in a single sweep
+*/
+void line_table_compact(assembler_ctx* ctx) {
+	int i, kept = 0;
+	
+	for(i=0; i < ctx->lines->current_size; i++) {
+		if(ctx->lines->offsets[i] != REMOVED_LINE) {
+			ctx->lines->offsets[kept++] = ctx->lines->offsets[i];
+		}
+	}
+	
+	ctx->lines->current_size = kept;
+}
+
+/*
+	This function appends every line in the table to the given output buffer
+*/
+void line_table_write_to_buffer(assembler_ctx* ctx, output_buffer* buffer) {
+	int i;
+	
+	if(buffer == NULL) return;
+	
+	for(i=0; i < ctx->lines->current_size; i++) {
+		writer_buffer_add_string(buffer, line_table_get_line(ctx, i));
+	}
+}
+
+/*
+This function doubles text until it can hold an amount of extra chars
+*/
+static void reserve_text(assembler_ctx* ctx, size_t length) {
+	if(ctx->lines->text_length + length + 1 <= ctx->lines->text_capacity) return;
+	
+	while(ctx->lines->text_length + length + 1 > ctx->lines->text_capacity) {
+		ctx->lines->text_capacity *= 2;
+	}
+	
+	ctx->lines->text = (char*)realloc(ctx->lines->text, ctx->lines->text_capacity * sizeof(char));
+	
+	if(ctx->lines->text == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+}
+
+/*
+This function records the offset of a new line at the end of text
+*/
+static void open_line(assembler_ctx* ctx) {
+	if(ctx->lines->current_size == ctx->lines->total_size) {
+		ctx->lines->total_size *= 2;
+		ctx->lines->offsets = (size_t*)realloc(ctx->lines->offsets, ctx->lines->total_size * sizeof(size_t));
+		
+		if(ctx->lines->offsets == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	ctx->lines->offsets[ctx->lines->current_size++] = ctx->lines->text_length;
+	ctx->lines->line_open = TRUE;
+}
\ No newline at end of file
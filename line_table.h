@@ -0,0 +1,61 @@
+#ifndef LINE_TABLE_H
+#define LINE_TABLE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "writer.h"
+#include "context.h"
+
+/*
+* This function initializes the line table holding the pre-assembled source
+*/
+void line_table_init(assembler_ctx*);
+
+/*
+* This function frees the line table
+*/
+void line_table_free(assembler_ctx*);
+
+/*
+* This function appends text to the table, every new line character ends a line
+*/
+void line_table_append(assembler_ctx*, char*, size_t);
+
+/*
+* This function appends a line with its tokens separated by the given delimiters,
+* copying each token followed by a single space
+*/
+void line_table_append_normalized(assembler_ctx*, char*, const char*);
+
+/*
+* This function returns the amount of lines in the table
+*/
+int line_table_get_length(assembler_ctx*);
+
+/*
+* This function recieves an index and returns the line at the index, including
+* its new line character
+*/
+char* line_table_get_line(assembler_ctx*, int);
+
+/*
+* This function replaces the line at an index with a new line
+*/
+void line_table_set_line(assembler_ctx*, int, char*);
+
+/*
+* This function marks the line at an index for removal by line_table_compact
+*/
+void line_table_remove_line(assembler_ctx*, int);
+
+/*
+* This function removes every line marked for removal, keeping the order of the rest
+*/
+void line_table_compact(assembler_ctx*);
+
+/*
+* This function appends every line in the table to the given output buffer
+*/
+void line_table_write_to_buffer(assembler_ctx*, output_buffer*);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "macro_library.h"
+#include "context.h"
+#include "macro_table.h"
+#include "line_table.h"
+#include "parser.h"
+#include "reader.h"
+#include "writer.h"
+#include "error.h"
+#include "utils.h"
+#include "constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* This function reads a whole file into a newly allocated block, returns NULL if it cannot be read */
+static char* read_file(char*, const char*, size_t*);
+/* This function pre-assembles the prelude and returns its serialized macro table */
+static char* build_library(char*, unsigned long, size_t*);
+
+
+/*
+	This function loads the macro library of a prelude file, reusing its .mlib
+	file when the content hash of the prelude has not changed
+*/
+int macro_library_load(char* prelude) {
+	char* text; /* Content of the prelude */
+	char* blob; /* Serialized macro library */
+	size_t length;
+	unsigned long hash;
+	FILE* mlib_file;
+	
+	text = read_file(prelude, ".as", &length);
+	if(text == NULL) {
+		raise_error(CANT_READ_FILE);
+		return FALSE;
+	}
+	
+	hash = utils_hash_buffer(text, length) & 0xFFFFFFFFUL;
+	free(text);
+	
+	/* Use the saved library if it was built from the same prelude */
+	blob = read_file(prelude, MACRO_LIBRARY_EXTENSION, &length);
+	if(blob != NULL) {
+		if(macro_table_load_library(blob, length, hash)) {
+			printf("Loaded macro library %s%s\n", prelude, MACRO_LIBRARY_EXTENSION);
+			return TRUE;
+		}
+		free(blob);
+	}
+	
+	blob = build_library(prelude, hash, &length);
+	if(blob == NULL) {
+		return FALSE;
+	}
+	
+	/* Save the library for the next runs */
+	mlib_file = writer_open_file(prelude, MACRO_LIBRARY_EXTENSION);
+	writer_write_buffer_to_file(mlib_file, blob, length);
+	fclose(mlib_file);
+	
+	printf("Built macro library %s%s\n", prelude, MACRO_LIBRARY_EXTENSION);
+	return macro_table_load_library(blob, length, hash);
+}
+
+/*
+	This function frees the macro library
+*/
+void macro_library_free() {
+	macro_table_free_library();
+}
+
+/*
+This function reads a whole file with the given name and extension into a newly allocated
+block and stores its length. Returns NULL if the file cannot be read.
+*/
+static char* read_file(char* file_name, const char* extension, size_t* length) {
+	char* full_file_name = utils_format_file_name(file_name, extension);
+	FILE* file = fopen(full_file_name, "rb");
+	char* text = NULL;
+	long size;
+	
+	free(full_file_name);
+	if(file == NULL) return NULL;
+	
+	if(fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+		text = (char*)malloc((size_t)size + 1);
+		
+		if(text == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+		
+		/* Read the whole file in a single read */
+		*length = fread(text, sizeof(char), (size_t)size, file);
+		if(*length != (size_t)size) {
+			free(text);
+			text = NULL;
+		}
+	}
+	
+	fclose(file);
+	return text;
+}
+
+/*
+This function pre-assembles the prelude and returns its macros serialized with the
+given content hash. Lines outside of macros are ignored.
+*/
+static char* build_library(char* prelude, unsigned long hash, size_t* length) {
+	char* blob = NULL;
+	assembler_ctx* ctx = context_new(); /* Context of the prelude, its macros become the library */
+	FILE* file = reader_open_file(ctx, prelude, ".as");
+	
+	if(file == NULL) {
+		context_flush(ctx);
+		context_free(ctx);
+		return NULL;
+	}
+	
+	macro_table_init(ctx);
+	line_table_init(ctx);
+	
+	if(parser_assemble_file(ctx, file)) {
+		context_flush(ctx);
+		if(line_table_get_length(ctx) > 0) {
+			raise_warning(IGNORED_PRELUDE_LINES);
+		}
+		blob = macro_table_serialize(ctx, hash, length);
+	}else {
+		context_flush(ctx);
+		raise_error(INVALID_MACRO_LIBRARY);
+	}
+	
+	context_free(ctx);
+	reader_close_file(file);
+	return blob;
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef MACRO_LIBRARY_H
+#define MACRO_LIBRARY_H
+
+/*
+* This function loads the macro library of a prelude file, given without its .as
+* extension. The macros are read from the serialized .mlib file of the prelude when
+* it was built from the same content, otherwise the prelude is pre-assembled and its
+* .mlib file is written again. Returns TRUE if the library is loaded, FALSE otherwise.
+*/
+int macro_library_load(char*);
+
+/*
+* This function frees the macro library
+*/
+void macro_library_free();
+
+#endif
\ No newline at end of file
@@ -1,133 +1,512 @@
-#include "macro_table.h"
-#include "error.h"
-#include "utils.h"
-#include <stdlib.h>
-#include <string.h>
-
-
-
-typedef struct Macro {
-	char* title;
-	char* info;
-} macro;
-
-typedef struct MacroTable {
-	struct Macro** list;
-	int current_size;
-	int total_size;
-} macro_table;
-
-/* Global pointer holding the macro table */
-macro_table* table;
-
-/*
-	This function initializes the macro table
-*/
-void macro_table_init() {
-    table = (macro_table*)malloc(sizeof(macro_table));
-	
-	if(table == NULL) {
-		raise_error(MEMORY_ERROR);
-		exit(FATAL_ERROR);
-	}
-	
-	table->list = (macro**)malloc(sizeof(macro*));
-	table->total_size = 1;
-	table->current_size = 0;
-}
-
-/*
-	This function frees the macro table
-*/
-void macro_table_free() {
-	int i;
-	
-	if(table == NULL) return;
-	
-	/* For each macro in the table, free all fields and the macro itself */
-	for(i=0; i < table->current_size; i++) {
-		if(table->list[i] != NULL) {
-			free(table->list[i]->title);
-			free(table->list[i]->info);
-			free(table->list[i]);
-		}
-	}
-	
-	/* Free table */
-	free(table->list);
-	free(table);
-}
-
-/*
-	This function adds a new macro to the table
-*/
-void macro_table_add_macro(char* title) {
-	/* Initialize new macro */
-	macro* mcr = (macro*)malloc(sizeof(macro));
-	
-	mcr->title = utils_duplicate_string(title);
-	mcr->info = (char*)calloc(sizeof(char), 1);
-	
-	/* Add macro to table */
-	if(table->current_size == table->total_size) {
-		table->list = (macro**)realloc(table->list, (++(table->total_size)) * sizeof(macro*));
-		
-		if (table == NULL) {
-			raise_error(MEMORY_ERROR);
-			exit(FATAL_ERROR);
-		}
-	}
-	
-	table->list[table->current_size++] = mcr;
-}
-
-/*
-	This function appends string to last table's macro
-*/
-void macro_table_append_to_last_macro(char* info) {
-	size_t calculated_length;
-	char* copy = NULL;
-	macro* mcr;
-	
-	if (table == NULL || table->list == NULL || table->current_size == 0) return;
-	
-	/* Pointer to the last macro for convenience */
-	mcr = table->list[table->current_size - 1];
-	
-	/* Calculate length needed to hold both the current info and the new info combined */
-	calculated_length = strlen(mcr->info) + strlen(info) + 2;
-	
-	/* Allocate memory */
-	copy = (char*)malloc(calculated_length * sizeof(char));
-	
-	/* Copy current info and append new info */
-	strcpy(copy, mcr->info);
-	strcat(copy, info);
-	strcat(copy, "\n");
-	
-	/* Free every byte of memory needed for this operation */
-	free(mcr->info);
-	mcr->info = copy;
-}
-
-/*
-	This function checks if a certain macro is in the table by name
-	Returns the index to the macro, and -1 if the macro is not in the table
-*/
-int macro_table_is_macro_in(char* title) {
-	int i;
-	
-	for(i=0; i < table->current_size; i++) {
-		if(!strcmp(title, table->list[i]->title)) {
-			return i;
-		}
-	}
-    return -1;
-}
-
-/*
-This function returns the info a macro
-*/
-char* macro_table_get_mcr_info(int index) {
-	return (table->list[index]->info);
+#include "macro_table.h"
+#include "error.h"
+#include "utils.h"
+#include "constants.h"
+#include "string_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+
+typedef struct Macro {
+	char* title; /* Macro name, interned in the pool of the table that defined it */
+	char* info; /* Macro body, kept null terminated */
+	size_t info_length; /* Amount of chars in the body */
+	size_t info_capacity; /* Amount of chars allocated for the body */
+	unsigned long hash; /* Hash of the title, compared before the title itself */
+} macro;
+
+/* Represents the expansion of a macro into the line table */
+typedef struct Expansion {
+	int index; /* Index of the expanded macro */
+	int line; /* Index of the first line of the expansion in the line table */
+} expansion;
+
+typedef struct MacroTable {
+	struct Macro** list;
+	int current_size;
+	int total_size;
+
+	int* index; /* Open addressing index, each slot holds an index to list or INVALID */
+	int index_size; /* Amount of slots in the index, always a power of 2 */
+	
+	int borrowed; /* Amount of macros at the start of list that belong to the macro library */
+	
+	string_pool* titles; /* Titles of the macros defined in the file */
+	
+	struct Expansion* expansions; /* Every expansion of a macro, in order of appearance */
+	int expansions_current_size;
+	int expansions_total_size;
+} macro_table;
+
+/* The macro library shared by every file, and the serialized
+   library its titles and infos point into */
+static macro_table* library;
+static macro* library_macros;
+static char* library_blob;
+
+/* This function returns the slot of a title in the index, or the empty slot it should be placed in */
+static int find_slot(macro_table*, char*, unsigned long);
+/* This function places a macro of the list in the index */
+static void index_macro(macro_table*, int);
+/* This function doubles the index and rehashes all macros into it */
+static void grow_index(macro_table*);
+/* This function allocates an empty table with room for an amount of macros */
+static macro_table* new_table(int);
+/* These functions write / read a number as 4 bytes of the serialized library */
+static void write_number(char*, unsigned long);
+static unsigned long read_number(char*);
+
+/*
+	This function initializes the macro table, starting with the macros of the
+	macro library if one is loaded
+*/
+void macro_table_init(assembler_ctx* ctx) {
+	if(library == NULL) {
+		ctx->macros = new_table(TABLE_BASE_SIZE);
+		return;
+	}
+	
+	/* Reuse the library's list and index as they are instead of rebuilding them */
+	ctx->macros = new_table(library->total_size);
+	free(ctx->macros->index);
+	ctx->macros->index = (int*)malloc(sizeof(int) * library->index_size);
+	
+	if(ctx->macros->index == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	memcpy(ctx->macros->list, library->list, sizeof(macro*) * library->current_size);
+	memcpy(ctx->macros->index, library->index, sizeof(int) * library->index_size);
+	ctx->macros->index_size = library->index_size;
+	ctx->macros->current_size = library->current_size;
+	ctx->macros->borrowed = library->current_size;
+}
+
+/*
+	This function frees the macro table
+*/
+void macro_table_free(assembler_ctx* ctx) {
+	int i;
+	
+	if(ctx->macros == NULL) return;
+	
+	/* For each macro defined in the file, free all fields and the macro itself */
+	for(i=ctx->macros->borrowed; i < ctx->macros->current_size; i++) {
+		if(ctx->macros->list[i] != NULL) {
+			free(ctx->macros->list[i]->info);
+			free(ctx->macros->list[i]);
+		}
+	}
+	
+	/* Free table, the titles are released with their pool */
+	string_pool_free(ctx->macros->titles);
+	free(ctx->macros->expansions);
+	free(ctx->macros->index);
+	free(ctx->macros->list);
+	free(ctx->macros);
+	ctx->macros = NULL;
+}
+
+/*
+	This function adds a new macro to the table
+*/
+void macro_table_add_macro(assembler_ctx* ctx, char* title) {
+	/* Initialize new macro */
+	macro* mcr = (macro*)malloc(sizeof(macro));
+	
+	mcr->title = string_pool_get(ctx->macros->titles, string_pool_intern(ctx->macros->titles, title, strlen(title)));
+	mcr->info = (char*)calloc(sizeof(char), MAX_LINE_LENGTH);
+	mcr->info_length = 0;
+	mcr->info_capacity = MAX_LINE_LENGTH;
+	mcr->hash = utils_hash_string(title);
+	
+	/* Add macro to table, doubling the list when it is full */
+	if(ctx->macros->current_size == ctx->macros->total_size) {
+		ctx->macros->total_size *= 2;
+		ctx->macros->list = (macro**)realloc(ctx->macros->list, ctx->macros->total_size * sizeof(macro*));
+		
+		if (ctx->macros->list == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	ctx->macros->list[ctx->macros->current_size++] = mcr;
+	
+	/* Keep the index at most half full so probe sequences stay short */
+	if(ctx->macros->current_size * 2 > ctx->macros->index_size) {
+		grow_index(ctx->macros);
+		return;
+	}
+	
+	index_macro(ctx->macros, ctx->macros->current_size - 1);
+}
+
+/*
+	This function appends string to last table's macro
+*/
+void macro_table_append_to_last_macro(assembler_ctx* ctx, char* info) {
+	size_t length;
+	macro* mcr;
+	
+	/* Macros of the library are never extended */
+	if (ctx->macros == NULL || ctx->macros->list == NULL || ctx->macros->current_size == ctx->macros->borrowed) return;
+	
+	/* Pointer to the last macro for convenience */
+	mcr = ctx->macros->list[ctx->macros->current_size - 1];
+	length = strlen(info);
+	
+	/* Double the body until it can hold the new info, a new line and a null character */
+	if(mcr->info_length + length + 2 > mcr->info_capacity) {
+		while(mcr->info_length + length + 2 > mcr->info_capacity) {
+			mcr->info_capacity *= 2;
+		}
+		
+		mcr->info = (char*)realloc(mcr->info, mcr->info_capacity * sizeof(char));
+		
+		if(mcr->info == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	/* Copy the new info right after the current body */
+	memcpy(mcr->info + mcr->info_length, info, length);
+	mcr->info_length += length;
+	mcr->info[mcr->info_length++] = '\n';
+	mcr->info[mcr->info_length] = '\0';
+}
+
+/*
+	This function checks if a certain macro is in the table by name
+	Returns the index to the macro, and -1 if the macro is not in the table
+*/
+int macro_table_is_macro_in(assembler_ctx* ctx, char* title) {
+	return ctx->macros->index[find_slot(ctx->macros, title, utils_hash_string(title))];
+}
+
+/*
+This function returns the info a macro
+*/
+char* macro_table_get_mcr_info(assembler_ctx* ctx, int index) {
+	return (ctx->macros->list[index]->info);
+}
+
+/*
+This function returns the length of the info of a macro
+*/
+size_t macro_table_get_mcr_info_length(assembler_ctx* ctx, int index) {
+	return (ctx->macros->list[index]->info_length);
+}
+
+/*
+This function returns the amount of macros in the table
+*/
+int macro_table_get_length(assembler_ctx* ctx) {
+	return ctx->macros->current_size;
+}
+
+/*
+This function returns the title of a macro
+*/
+char* macro_table_get_mcr_title(assembler_ctx* ctx, int index) {
+	return (ctx->macros->list[index]->title);
+}
+
+/*
+This function records that a macro was expanded starting at a line of the line table
+*/
+void macro_table_record_expansion(assembler_ctx* ctx, int index, int line) {
+	if(ctx->macros->expansions_current_size == ctx->macros->expansions_total_size) {
+		ctx->macros->expansions_total_size *= 2;
+		ctx->macros->expansions = (expansion*)realloc(ctx->macros->expansions, ctx->macros->expansions_total_size * sizeof(expansion));
+		
+		if(ctx->macros->expansions == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	ctx->macros->expansions[ctx->macros->expansions_current_size].index = index;
+	ctx->macros->expansions[ctx->macros->expansions_current_size].line = line;
+	ctx->macros->expansions_current_size++;
+}
+
+/*
+This function returns the amount of expansions recorded
+*/
+int macro_table_get_expansions_length(assembler_ctx* ctx) {
+	return ctx->macros->expansions_current_size;
+}
+
+/*
+This function returns the index of the macro expanded by an expansion
+*/
+int macro_table_get_expansion_macro(assembler_ctx* ctx, int expansion_index) {
+	return ctx->macros->expansions[expansion_index].index;
+}
+
+/*
+This function returns the first line of an expansion in the line table
+*/
+int macro_table_get_expansion_line(assembler_ctx* ctx, int expansion_index) {
+	return ctx->macros->expansions[expansion_index].line;
+}
+
+/*
+This function serializes every macro in the table into a single block of memory that
+can be saved to a file and later loaded, or mapped, by macro_table_load_library.
+The block starts with a header of the library's magic, format version, the given content
+hash and the amount of macros, followed by the title offset, info offset and info length
+of each macro and then the null terminated titles and infos. All numbers take 4 bytes.
+*/
+char* macro_table_serialize(assembler_ctx* ctx, unsigned long hash, size_t* length) {
+	int i;
+	char* blob;
+	char* entry;
+	size_t offset;
+	macro* mcr;
+	
+	/* Calculate the size of the header, the entries and the strings */
+	offset = MACRO_LIBRARY_HEADER_SIZE + (size_t)ctx->macros->current_size * MACRO_LIBRARY_ENTRY_SIZE;
+	*length = offset;
+	for(i=0; i < ctx->macros->current_size; i++) {
+		*length += strlen(ctx->macros->list[i]->title) + ctx->macros->list[i]->info_length + 2;
+	}
+	
+	blob = (char*)malloc(*length);
+	
+	if(blob == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	memcpy(blob, MACRO_LIBRARY_MAGIC, 4);
+	write_number(blob + 4, MACRO_LIBRARY_VERSION);
+	write_number(blob + 8, hash);
+	write_number(blob + 12, (unsigned long)ctx->macros->current_size);
+	
+	for(i=0; i < ctx->macros->current_size; i++) {
+		mcr = ctx->macros->list[i];
+		entry = blob + MACRO_LIBRARY_HEADER_SIZE + (size_t)i * MACRO_LIBRARY_ENTRY_SIZE;
+		
+		write_number(entry, (unsigned long)offset);
+		strcpy(blob + offset, mcr->title);
+		offset += strlen(mcr->title) + 1;
+		
+		write_number(entry + 4, (unsigned long)offset);
+		write_number(entry + 8, (unsigned long)mcr->info_length);
+		memcpy(blob + offset, mcr->info, mcr->info_length + 1);
+		offset += mcr->info_length + 1;
+	}
+	
+	return blob;
+}
+
+/*
+This function validates a serialized library against the expected content hash and makes it
+the library every new macro table starts with. The titles and infos are used in place.
+Returns TRUE and takes ownership of the block if it is valid, FALSE otherwise.
+*/
+int macro_table_load_library(char* blob, size_t length, unsigned long hash) {
+	int i, count;
+	char* entry;
+	macro* macros;
+	unsigned long title_offset, info_offset, info_length;
+	
+	/* Check the header */
+	if(length < MACRO_LIBRARY_HEADER_SIZE || memcmp(blob, MACRO_LIBRARY_MAGIC, 4) ||
+		read_number(blob + 4) != MACRO_LIBRARY_VERSION || read_number(blob + 8) != hash) {
+		return FALSE;
+	}
+	
+	count = (int)read_number(blob + 12);
+	if(count < 0 || (length - MACRO_LIBRARY_HEADER_SIZE) / MACRO_LIBRARY_ENTRY_SIZE < (size_t)count) {
+		return FALSE;
+	}
+	
+	/* Check that every title and info lies inside the block and is null terminated */
+	for(i=0; i < count; i++) {
+		entry = blob + MACRO_LIBRARY_HEADER_SIZE + (size_t)i * MACRO_LIBRARY_ENTRY_SIZE;
+		title_offset = read_number(entry);
+		info_offset = read_number(entry + 4);
+		info_length = read_number(entry + 8);
+		
+		if(title_offset >= length || memchr(blob + title_offset, '\0', length - title_offset) == NULL ||
+			info_offset >= length || info_length >= length - info_offset || blob[info_offset + info_length] != '\0') {
+			return FALSE;
+		}
+	}
+	
+	macro_table_free_library();
+	library = new_table(count > 0 ? count : 1);
+	macros = (macro*)malloc(sizeof(macro) * (count > 0 ? count : 1));
+	
+	if(macros == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	for(i=0; i < count; i++) {
+		entry = blob + MACRO_LIBRARY_HEADER_SIZE + (size_t)i * MACRO_LIBRARY_ENTRY_SIZE;
+		
+		macros[i].title = blob + read_number(entry);
+		macros[i].info = blob + read_number(entry + 4);
+		macros[i].info_length = read_number(entry + 8);
+		macros[i].info_capacity = macros[i].info_length + 1;
+		macros[i].hash = utils_hash_string(macros[i].title);
+		
+		library->list[library->current_size++] = macros + i;
+		
+		if(library->current_size * 2 > library->index_size) {
+			grow_index(library);
+		} else {
+			index_macro(library, library->current_size - 1);
+		}
+	}
+	
+	library_macros = macros;
+	library_blob = blob;
+	return TRUE;
+}
+
+/*
+This function frees the macro library
+*/
+void macro_table_free_library() {
+	if(library == NULL) return;
+	
+	/* All the macros of the library were allocated as one block */
+	string_pool_free(library->titles);
+	free(library_macros);
+	free(library->expansions);
+	free(library->index);
+	free(library->list);
+	free(library);
+	free(library_blob);
+	library = NULL;
+	library_macros = NULL;
+	library_blob = NULL;
+}
+
+/*
+This function probes the index linearly from the title's hash and returns the slot
+holding the title, or the first empty slot if the title is not in the table
+*/
+static int find_slot(macro_table* target, char* title, unsigned long hash) {
+	int mask = target->index_size - 1;
+	int slot = (int)(hash & mask);
+	macro* mcr;
+	
+	while(target->index[slot] != INVALID) {
+		mcr = target->list[target->index[slot]];
+		
+		if(mcr->hash == hash && !strcmp(title, mcr->title)) {
+			return slot;
+		}
+		slot = (slot + 1) & mask;
+	}
+	
+	return slot;
+}
+
+/*
+This function places a macro of the list in the index. A title redefined in the file keeps
+pointing to its first definition, but a definition in the file hides one of the library
+*/
+static void index_macro(macro_table* target, int index) {
+	int slot = find_slot(target, target->list[index]->title, target->list[index]->hash);
+	
+	if(target->index[slot] == INVALID || (target->index[slot] < target->borrowed && index >= target->borrowed)) {
+		target->index[slot] = index;
+	}
+}
+
+/*
+This function doubles the size of the index and reinserts every macro in
+definition order
+*/
+static void grow_index(macro_table* target) {
+	int i;
+	
+	free(target->index);
+	target->index_size *= 2;
+	target->index = (int*)malloc(sizeof(int) * target->index_size);
+	
+	if(target->index == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	for(i=0; i < target->index_size; i++) {
+		target->index[i] = INVALID;
+	}
+	
+	for(i=0; i < target->current_size; i++) {
+		index_macro(target, i);
+	}
+}
+
+/*
+This function allocates an empty table with room for an amount of macros
+*/
+static macro_table* new_table(int size) {
+	int i;
+	macro_table* target = (macro_table*)malloc(sizeof(macro_table));
+	
+	if(target == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	target->list = (macro**)malloc(sizeof(macro*) * size);
+	target->total_size = size;
+	target->current_size = 0;
+	target->borrowed = 0;
+	target->titles = string_pool_new();
+	
+	target->index = (int*)malloc(sizeof(int) * HASH_BASE_SIZE);
+	target->index_size = HASH_BASE_SIZE;
+	
+	target->expansions = (expansion*)malloc(sizeof(expansion) * TABLE_BASE_SIZE);
+	target->expansions_current_size = 0;
+	target->expansions_total_size = TABLE_BASE_SIZE;
+	
+	if(target->list == NULL || target->index == NULL || target->expansions == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	for(i=0; i < target->index_size; i++) {
+		target->index[i] = INVALID;
+	}
+	
+	return target;
+}
+
+/*
+This function writes the lower 32 bits of a number as 4 bytes, least significant first
+*/
+static void write_number(char* dest, unsigned long number) {
+	int i;
+	
+	for(i=0; i < 4; i++) {
+		dest[i] = (char)((number >> (8 * i)) & 0xFF);
+	}
+}
+
+/*
+This function reads a number written by write_number
+*/
+static unsigned long read_number(char* source) {
+	int i;
+	unsigned long number = 0;
+	
+	for(i=3; i >= 0; i--) {
+		number = (number << 8) | (unsigned char)source[i];
+	}
+	
+	return number;
 }
\ No newline at end of file
@@ -1,35 +1,100 @@
-#ifndef MACRO_TABLE_H
-#define MACRO_TABLE_H
-
-/*
-* This function initializes the macro table
-*/
-void macro_table_init();
-
-/*
-* This function frees the macro table
-*/
-void macro_table_free();
-
-/*
-* This function adds a new macro to the table 
-*/
-void macro_table_add_macro(char*);
-
-/*
-* This function appends string to last table's macro
-*/
-void macro_table_append_to_last_macro(char*);
-
-/*
-* This function checks if a certain macro is in the table by name
-* Returns the index to the macro, and -1 if the macro is not in the table
-*/
-int macro_table_is_macro_in(char*);
-
-/*
-* This function recieves an index and returns the macro's info at the index
-*/
-char* macro_table_get_mcr_info(int);
-
+#ifndef MACRO_TABLE_H
+#define MACRO_TABLE_H
+
+#include <stddef.h>
+#include "context.h"
+
+#define MACRO_LIBRARY_EXTENSION ".mlib" /* Extension of a serialized macro library file */
+#define MACRO_LIBRARY_MAGIC "MLIB" /* First 4 bytes of a serialized macro library */
+#define MACRO_LIBRARY_VERSION 1 /* Format version of a serialized macro library */
+#define MACRO_LIBRARY_HEADER_SIZE 16
+#define MACRO_LIBRARY_ENTRY_SIZE 12
+
+/*
+* This function initializes the macro table, starting with the macros of the
+* macro library if one is loaded
+*/
+void macro_table_init(assembler_ctx*);
+
+/*
+* This function frees the macro table
+*/
+void macro_table_free(assembler_ctx*);
+
+/*
+* This function adds a new macro to the table 
+*/
+void macro_table_add_macro(assembler_ctx*, char*);
+
+/*
+* This function appends string to last table's macro
+*/
+void macro_table_append_to_last_macro(assembler_ctx*, char*);
+
+/*
+* This function checks if a certain macro is in the table by name
+* Returns the index to the macro, and -1 if the macro is not in the table
+*/
+int macro_table_is_macro_in(assembler_ctx*, char*);
+
+/*
+* This function recieves an index and returns the macro's info at the index
+*/
+char* macro_table_get_mcr_info(assembler_ctx*, int);
+
+/*
+* This function recieves an index and returns the length of the macro's info
+*/
+size_t macro_table_get_mcr_info_length(assembler_ctx*, int);
+
+/*
+* This function returns the amount of macros in the table
+*/
+int macro_table_get_length(assembler_ctx*);
+
+/*
+* This function recieves an index and returns the macro's title at the index
+*/
+char* macro_table_get_mcr_title(assembler_ctx*, int);
+
+/*
+* This function records that the macro at an index was expanded starting at a
+* line of the line table
+*/
+void macro_table_record_expansion(assembler_ctx*, int, int);
+
+/*
+* This function returns the amount of expansions recorded
+*/
+int macro_table_get_expansions_length(assembler_ctx*);
+
+/*
+* This function recieves an index to an expansion and returns the index of the
+* macro it expanded
+*/
+int macro_table_get_expansion_macro(assembler_ctx*, int);
+
+/*
+* This function recieves an index to an expansion and returns the line table
+* index of its first line
+*/
+int macro_table_get_expansion_line(assembler_ctx*, int);
+
+/*
+* This function serializes the macro table with the given content hash into a
+* newly allocated block and stores its length
+*/
+char* macro_table_serialize(assembler_ctx*, unsigned long, size_t*);
+
+/*
+* This function loads a serialized block as the macro library if it is valid and
+* matches the given content hash, returns TRUE if loaded and FALSE otherwise
+*/
+int macro_table_load_library(char*, size_t, unsigned long);
+
+/*
+* This function frees the macro library
+*/
+void macro_table_free_library();
+
 #endif
\ No newline at end of file
@@ -1,65 +1,182 @@
-#include "main.h"
-#include "error.h"
-#include "reader.h"
-#include "writer.h"
-#include "parser.h"
-#include "symbol_table.h"
-#include "translator.h"
-#include "image.h"
-
-int main(int argc, char* argv[]){
-	FILE* file; /* Pointer to current file being proccessed */
-	int success, i; /* flag if proccess is successful, counter */
-	
-	/* If too few commandline arguments, exit program */
-	if(argc < 2){
-		raise_error(INVALID_ARGUMENTS);
-		exit(FATAL_ERROR);
-	}
-	
-	
-	for(i=1; i < argc; i++){
-		/* Open file */
-		file = reader_open_file(argv[i], ".as");
-		
-		/* If file doesn't exist continue to next argument */
-		if(file == NULL) continue;
-		
-		/* Spread macros, ignore comments and emptylines and create new .am file */
-		success = parser_assemble_file(file, argv[i]);
-		reader_close_file(file);
-		
-		/* If pre-assembly not successful go to next argument */
-		if(!success)
-			continue;
-		
-		
-		symbol_table_init(); /* Initialize symbol table */
-		file = reader_open_file(argv[i], ".am"); /* Open .am file */
-		
-		parser_first_pass(file); /* Check initial errors and symbol table */
-		
-		rewind(file); /* Rewind to start of the file */
-		image_init(); /* Initialize instructions and data images */
-		
-		/* Check complex errors and create initial translation to binary */
-		success = parser_second_pass(file, argv[i]);
-		
-		/* If both passes are without errors than write files */
-		if (success) {
-			fprintf(stdout, "Success!\n\n");
-			writer_write_output_files(argv[i]);
-			fprintf(stdout, "Finished!\n");
-		}else {
-			fprintf(stdout, "Failed!\n");
-		}
-		
-		/* Free allocated structures and close file pointer */
-		image_free();
-		reader_close_file(file);
-		symbol_table_free();
-	}
-	
-	
-	return 0;
+#include "main.h"
+#include "context.h"
+#include "error.h"
+#include "reader.h"
+#include "writer.h"
+#include "parser.h"
+#include "symbol_table.h"
+#include "translator.h"
+#include "image.h"
+#include "line_table.h"
+#include "macro_table.h"
+#include "macro_library.h"
+#include "line_mask.h"
+#include "batch.h"
+#include "constants.h"
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+
+/* This function assembles a single file in the given context */
+static void assemble_file(assembler_ctx*, char*, void*);
+/* This function reads a positive count of an option, INVALID if it is not one */
+static int parse_count(char*);
+
+
+int main(int argc, char* argv[]){
+	assembler_ctx* ctx; /* Context of current file being proccessed */
+	int i; /* counter */
+	assembler_options options; /* Options every file is assembled with */
+	char* prelude = NULL; /* Name of the macro library prelude file */
+	int jobs = 1; /* Number of files assembled at once */
+	int files = 0; /* Number of files given in commandline */
+	
+	options.emit_am = FALSE;
+	options.optimize_size = FALSE;
+	options.split = 1;
+	
+	/* Read options and clear them from argv, every other argument is a file name */
+	for(i=1; i < argc; i++){
+		if(!strcmp(argv[i], EMIT_AM_OPTION)){
+			options.emit_am = TRUE;
+			argv[i] = NULL;
+		}
+		else if(!strcmp(argv[i], OPTIMIZE_SIZE_OPTION)){
+			options.optimize_size = TRUE;
+			argv[i] = NULL;
+		}
+		else if(!strcmp(argv[i], MACRO_LIBRARY_OPTION) && i + 1 < argc){
+			argv[i++] = NULL;
+			prelude = argv[i];
+			argv[i] = NULL;
+		}
+		else if(!strcmp(argv[i], JOBS_OPTION) && i + 1 < argc){
+			argv[i++] = NULL;
+			jobs = parse_count(argv[i]);
+			argv[i] = NULL;
+			
+			if(jobs == INVALID){
+				raise_error(INVALID_JOBS);
+				exit(FATAL_ERROR);
+			}
+		}
+		else if(!strcmp(argv[i], SPLIT_OPTION) && i + 1 < argc){
+			argv[i++] = NULL;
+			options.split = parse_count(argv[i]);
+			argv[i] = NULL;
+			
+			if(options.split == INVALID){
+				raise_error(INVALID_SPLIT);
+				exit(FATAL_ERROR);
+			}
+		}
+		else
+			argv[++files] = argv[i];
+	}
+	
+	/* If too few commandline arguments, exit program */
+	if(files == 0){
+		raise_error(INVALID_ARGUMENTS);
+		exit(FATAL_ERROR);
+	}
+	
+	/* Load the macro library once for all files */
+	if(prelude != NULL && !macro_library_load(prelude)){
+		exit(FATAL_ERROR);
+	}
+	
+	/* Choose the kernels before any thread uses them */
+	if(jobs > 1 || options.split > 1){
+		translator_init();
+		line_mask_init();
+	}
+	
+	/* The file names are kept at the start of argv, assemble them side by side when requested */
+	if(jobs > 1){
+		batch_assemble(argv + 1, files, jobs, assemble_file, &options);
+	}
+	else{
+		for(i=1; i <= files; i++){
+			/* Every file is assembled in a context of its own */
+			ctx = context_new();
+			assemble_file(ctx, argv[i], &options);
+			
+			/* Write the messages of the file at once */
+			context_flush(ctx);
+			context_free(ctx);
+		}
+	}
+	
+	macro_library_free();
+	return 0;
+}
+
+/*
+	This function assembles a single file in the given context, every table it builds
+	is freed by the context
+*/
+static void assemble_file(assembler_ctx* ctx, char* file_name, void* options){
+	assembler_options* current = (assembler_options*)options;
+	FILE* file; /* Pointer to the file being proccessed */
+	int success; /* flag if proccess is successful */
+	
+	/* Open file */
+	file = reader_open_file(ctx, file_name, ".as");
+	
+	/* If file doesn't exist continue to next argument */
+	if(file == NULL) return;
+	
+	/* Spread macros, ignore comments and emptylines into the line table */
+	line_table_init(ctx);
+	macro_table_init(ctx);
+	success = parser_assemble_file(ctx, file);
+	
+	/* Replace repeated macro expansions with subroutine calls */
+	if(success && current->optimize_size)
+		parser_outline_macros(ctx, OUTLINE_THRESHOLD);
+	
+	macro_table_free(ctx);
+	reader_close_file(file);
+	
+	/* Write the .am file only when requested */
+	if(success && current->emit_am)
+		writer_write_am_file(ctx, file_name);
+	
+	/* If pre-assembly not successful go to next argument */
+	if(!success) return;
+	
+	
+	symbol_table_init(ctx); /* Initialize symbol table */
+	image_init(ctx, MEMORY_SIZE, MEMORY_SIZE); /* Initialize instructions and data images, each can take the whole memory */
+	
+	/* Check errors, build the symbol table and translate to binary */
+	if(current->split > 1)
+		success = parser_split_pass(ctx, current->split);
+	else
+		success = parser_single_pass(ctx);
+	
+	/* If the file is without errors than write files */
+	if (success) {
+		context_message(ctx, "Success!\n\n");
+		writer_write_output_files(ctx, file_name);
+		context_message(ctx, "Finished!\n");
+	}else {
+		context_message(ctx, "Failed!\n");
+	}
+}
+/*
+Reads the count given to an option. Counts which are not whole positive numbers, or
+which are out of the range of an int, are refused rather than truncated
+*/
+static int parse_count(char* text){
+	char* end; /* End of the count */
+	long count;
+	
+	errno = 0;
+	count = strtol(text, &end, 10);
+	
+	if(end == text || *end != '\0' || errno == ERANGE || count < 1 || count > INT_MAX){
+		return INVALID;
+	}
+	return (int)count;
 }
\ No newline at end of file
@@ -1,7 +1,28 @@
-#ifndef MAIN_H
-#define MAIN_H
-
-#include <stdio.h>
-#include <stdlib.h>
-
-#endif
+#ifndef MAIN_H
+#define MAIN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define EMIT_AM_OPTION "--emit-am" /* Option to write the pre-assembled .am file */
+#define OPTIMIZE_SIZE_OPTION "--Os" /* Option to outline macros expanded many times into subroutines */
+/*
+* Macros expanded more times than this are outlined in --Os mode. Every call takes 2 words
+* and the subroutine adds an 'rts' word, so a macro expanded twice must have a body of at
+* least 6 words to save any, while it costs a jump at run time on every expansion. Below 3
+* expansions the saving is too small for that cost, more expansions are left to the check
+* of the words actually saved
+*/
+#define OUTLINE_THRESHOLD 2
+#define MACRO_LIBRARY_OPTION "--macros" /* Option followed by a prelude file of macros shared by all files */
+#define JOBS_OPTION "-j" /* Option followed by the amount of files assembled at once */
+#define SPLIT_OPTION "--split" /* Option followed by the amount of chunks the lines of a file are assembled in at once */
+
+/* Represents the options every file is assembled with */
+typedef struct AssemblerOptions {
+	int emit_am; /* flag if .am files should be written */
+	int optimize_size; /* flag if repeated macros should be outlined */
+	int split; /* Amount of chunks the lines of each file are assembled in at once */
+} assembler_options;
+
+#endif
\ No newline at end of file
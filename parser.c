@@ -1,664 +1,1005 @@
-#include "parser.h"
-#include "utils.h"
-#include "error.h"
-#include "writer.h"
-#include "reader.h"
-#include "globals.h"
-#include "constants.h"
-#include "symbol_table.h"
-#include "macro_table.h"
-#include "translator.h"
-#include "lexer.h"
-
-/*---------------------------------------------------------- 
-Pre-Assembly phase of the parser
-----------------------------------------------------------*/
-
-/* Check if the line contains no tokens (empty line). */
-static int is_empty_line(char**, int);
-
-/* Check if the line is a comment (starts with a semicolon ';'). */
-static int is_comment(char**, int);
-
-/* Handle the procedure when inside a macro. */
-static int in_macro_procedure(char**, int);
-
-/* Handle the procedure when not inside a macro. */
-static int not_in_macro_procedure(char**, int, FILE*);
-
-
-/* Assemble the input file and generate the .am file. 
-    Return 1 if successful, and 0 otherwise */
-int parser_assemble_file(FILE* file, char* file_name){
-	/* Assuming input is less than 80 characters */
-    char input_line[MAX_LINE_LENGTH]; /* Current line being processed */
-    FILE* writer_file;
-    
-    int token_count = 0; /* Number of tokens in a line */
-    char** tokens; /* Array of tokens */
-    
-    int in_macro = 0; /* Flag indicating if currently inside a macro */
-    /* macro* current_macro; Pointer to the current macro */
-    
-    
-    /* table = list_init_macro_table(); Initialize the macro table */
-    macro_table_init();
-    writer_file = writer_open_file(file_name, ".am"); /* Open .am file for writing */
-	line_num = 0; /* Initialize current line num to 1 */
-    errors = 0; /* Initialize error count to zero */
-    
-    while(fgets(input_line, MAX_LINE_LENGTH, file) != NULL){
-        /* Tokenize string into an array of tokens */
-        tokens = utils_tokenize(input_line, &token_count, " \t\n\r");
-		line_num++;
-        
-		
-        if(is_empty_line(tokens, token_count))
-            continue;
-        
-        if(is_comment(tokens, token_count))
-            continue;
-        
-        /* Check if currently inside a macro or not, initiate proper procedure, and update the 'in_macro' flag */
-        if(in_macro)
-            in_macro = in_macro_procedure(tokens, token_count);
-        else
-            in_macro = not_in_macro_procedure(tokens, token_count, writer_file);
-        
-        utils_free_tokens(tokens, token_count); /* Free memory used by tokens */
-    }
-    
-    /* list_free_macro_table(table);  Free memory used by the macro table */
-    macro_table_free();
-    printf("End of file\n");
-    
-    /* If there are any errors, remove the .am file */
-    if(errors) {
-        writer_remove_file(file_name, ".am");
-    }
-    fclose(writer_file); /* Close the .am file */
-    
-    /* Return TRUE if there are no errors, FALSE otherwise */
-    return (errors == 0) ? TRUE : FALSE;
-}
-
-
-
-
-/* Handle the procedure when inside a macro.
- * Returns:
- *  - TRUE if the procedure continues inside a macro, FALSE if 'endmcro' is found.
- */
-static int in_macro_procedure(char** tokens, int token_count){
-    char* line;
-    
-    /* Assuming 'endmcro' declaration is valid, and is the only token in the input line */
-    /* If we reach 'endmcro', return FALSE to indicate the end of the macro */
-    if(!strncmp(tokens[0], "endmcro", 7)){
-        /* If there are tokens other than 'endmcro', display an error */
-        if(token_count != 1){
-            raise_error_in_line(INVALID_ENDMCRO, line_num);
-        }
-        return FALSE;
-    }
-    
-    line = utils_merge_tokens(tokens, token_count); /* Merge tokens into a single line */
-    /* list_macro_append(mcr, line);  Append the line to the current macro's info */
-    macro_table_append_to_last_macro(line);
-    
-    free(line); /* Free the memory used by the merged line */
-    return TRUE; /* Continue in the macro procedure */
-}
-
-
-/* Handle the procedure when not inside a macro.
- * Returns:
- *  - TRUE if the procedure continues not inside a macro, FALSE if a 'mcro' is found.
- */
-static int not_in_macro_procedure(char** tokens, int token_count, FILE* writer_file){
-    int index_to_macro;
-    
-    /* If 'mcro' declaration is found */
-    if(!strncmp(tokens[0], "mcro", 4)){
-        /* If there are not exactly 2 tokens in line(mcro and title), display an error */
-        if (token_count != 2 || error_invalid_keyword(tokens[1])) {
-            raise_error_in_line(INVALID_MCRO, line_num);
-        }
-        
-        macro_table_add_macro(tokens[1]);
-        return TRUE;
-    }
-    
-	/* Check if current token exists as a macro in the table */
-    /* current_macro = list_find_macro(tokens[0]); */
-    index_to_macro = macro_table_is_macro_in(tokens[0]);
-	
-    if (index_to_macro != -1) {
-        writer_write_string_to_file(writer_file, macro_table_get_mcr_info(index_to_macro)); /* Write macro's info to file */
-        return FALSE; /* Continue not in the macro procedure */
-    }
-    
-    writer_write_tokens_to_file(writer_file, tokens, token_count); /* Write tokens to file */
-    return FALSE; /* Continue not in the macro procedure */
-}
-
-
-
-
-
-/* Check if the line contains no tokens (empty line).
- * Returns:
- *  - TRUE if the line is empty, FALSE otherwise.
- */
-static int is_empty_line(char** tokens, int token_count){
-    if(token_count == 0){
-        utils_free_tokens(tokens, token_count); /* Free memory used by tokens */
-        return TRUE;
-    }
-    return FALSE;
-}
-
-/* Check if the line is a comment (starts with a semicolon ';').
- * Returns:
- *  - TRUE if the line is a comment, FALSE otherwise.
- */
-static int is_comment(char** tokens, int token_count){
-    if(!strncmp(tokens[0], ";", 1)){
-        utils_free_tokens(tokens, token_count); /* Free memory used by tokens */
-        return TRUE;
-    }
-    return FALSE;
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-/*---------------------------------------------------------- 
-First pass phase of the assembler
-----------------------------------------------------------*/
-
-/* Check if the first token is a valid symbol (label). */
-static int is_first_token_symbol(char**, int);
-
-/* Check if the token indicates a data declaration. */
-static int valid_symbol(char*);
-
-/* Check if the token indicates a string declaration. */
-static int is_data(char*);
-
-/* Calculate the number of characters needed for a string. */
-static int is_string(char*);
-
-/* Calculate the number of integers in a .data declaration. */
-static int calculate_chars(char**, int, int, char*);
-
-/* Check if a symbol exists in the symbol table. */
-static int calculate_integers(char**, int, int);
-
-/* Calculate the length (number of rows) required for the instruction's encoding. */
-static int is_symbol_in_table(char**, int);
-
-/* Check if a token is a valid register. */
-static int calculate_ic_length(char**, int, int);
-
-/* Check if a line indicates an .extern declaration. */
-static int is_register(char*);
-
-/* Check if a line indicates an .entry declaration. */
-static int is_extern(char**, int);
-
-/* Add extern symbols to the symbol table. */
-static int is_entry(char**, int);
-
-/* Perform the first pass of the assembly process. */
-static void add_externs_to_table(char**, int, int);
-
-
-/* 
-This first pass is responsible for initial error checking in the file, and the creation
-of a symbol table. and classification of each symbol
-*/
-void parser_first_pass(FILE* file) {
-	
-	char input_line[MAX_LINE_LENGTH] = {0}; /* Input line */
-	char** tokens = NULL; /* Array of tokens */
-	int token_count = 0; /* Num of Tokens */
-	
-	int is_symbol; /* Is Symbol / Label  flag*/
-    
-	ic = 0; /* Initialize ic to 0 */
-    dc = 0; /* Initialize dc to 0 */
-	line_num = 0; /* Initialize number of line to 0 */
-	errors = 0; /* Initialize errors to 0 */
-    
-    fprintf(stdout, "Starting initial error handling...\nBuilding symbol table ...\n");
-	
-	while(fgets(input_line, MAX_LINE_LENGTH, file) != NULL) {
-        line_num++;
-        
-        /* Tokenize line to different tokens */
-        tokens = utils_tokenize(input_line, &token_count, " ,\t\n\r");
-        
-        /* Check if first token is symbol then turn flag to TRUE */
-        is_symbol = is_first_token_symbol(tokens, token_count);
-        
-        /* If there is a symbol declaration and it already exists, raise error and continue to next line */
-        if (is_symbol) {
-            if (is_symbol_in_table(tokens, 0) || !valid_symbol(tokens[0])) {
-                utils_free_tokens(tokens, token_count);
-                continue;
-            }
-            
-            /* If its an empty symbol declaration raise error */
-            if(token_count == 1) {
-                raise_error_in_line(EMPTY_LABEL, line_num);
-                utils_free_tokens(tokens, token_count);
-                continue;
-            }
-        }
-        
-        /* If its a .data declaration */
-        if(is_data(tokens[is_symbol])) {
-            /* If its also a symbol add it to symbol table */
-            if(is_symbol) {
-                symbol_table_append(tokens[0], DC_TYPE, dc);
-            }
-            
-            /* Calculate number of rows needed for the encoding of the data */
-            dc += calculate_integers(tokens, token_count, is_symbol + 1);
-            utils_free_tokens(tokens, token_count);
-            continue;
-        }
-        
-        /* If its a .string declaration */
-        if(is_string(tokens[is_symbol])) {
-            /* If its also a symbol, add to symbol table */
-            if(is_symbol){
-                symbol_table_append(tokens[0], DC_TYPE, dc);
-            }
-            
-            /* Calculate number of rows needed for the enoding of the string */
-            dc += calculate_chars(tokens, token_count, is_symbol + 1, input_line);
-            utils_free_tokens(tokens, token_count);
-            continue;
-        }
-        
-        /* If its extern we handle it in a seperate function */
-        if(is_extern(tokens, is_symbol)) {
-            add_externs_to_table(tokens, token_count, is_symbol);
-            utils_free_tokens(tokens, token_count);
-            continue;
-        }
-        
-        /* If its .entry declaration we continue to next line since we only handle it in the second pass */
-        if(is_entry(tokens, is_symbol)) {
-            utils_free_tokens(tokens, token_count);
-            continue;
-        }
-        
-        /* If non of the ifs so far are met, that means the line is an instruction */
-        
-        /* Check for initial errors in the instruction line */
-        error_check_instruction(input_line, is_symbol, tokens, token_count);
-        
-        /* If its symbol than add it to the symbol table as instruction */
-        if(is_symbol) {
-            symbol_table_append(tokens[0], IC_TYPE, ic);
-        }
-    
-        /* Increment IC with the total lines required by the instruction */
-        ic += calculate_ic_length(tokens, token_count, is_symbol);
-        utils_free_tokens(tokens, token_count);
-	}
-    
-    /* Update symbol addresses (since memory begins at 100 and data begins at 100 + IC) */
-    symbol_table_update_addresses(ic);
-    
-    /* Debugging purposes */
-    fprintf(stdout, "Symbol Table:\n");
-    symbol_table_print();
-    fprintf(stdout, "\n\n");
-}
-
-/* Validate if a symbol (label) is valid. */
-static int valid_symbol(char* name) {
-    size_t length;
-    char* copy;
-    
-    copy = utils_duplicate_string(name);
-    length = strlen(name);
-    
-    /* Remove trailing ':' if present */
-    if(copy[length-1] == ':') {
-        copy[length-1] = '\0';
-    }
-    
-    /* If symbol is too long or doesnt start with alphabetic letter or is a reserved 
-    keyword, than raise error. */
-    if (length >= MAX_LABEL_LENGTH || !isalpha(name[0]) || error_invalid_keyword(copy)) {
-        raise_error_in_line(INVALID_LABEL, line_num);
-        free(copy);
-        return FALSE;
-    }
-    
-    free(copy);
-    return TRUE;
-}
-
-/* Check if the first token in a line is a symbol (label). */
-static int is_first_token_symbol(char** tokens, int token_count) {
-    int length = strlen(tokens[0]);
-    
-    /* If last char of the string is ':' than return true */
-    if (tokens[0][length-1] == ':') {
-        return TRUE;
-    }
-    return FALSE;
-}
-
-/* Check if a token represents a .data declaration. */
-static int is_data(char* token) {
-    return !strcmp(token, ".data");
-}
-
-/* Check if a token represents a .string declaration. */
-static int is_string(char* token) {
-    return !strcmp(token, ".string");
-}
-
-/* Calculate the number of characters needed for a string. */
-static int calculate_chars(char** tokens, int token_count, int start_index, char* line) {
-    int i;
-    int counter = 0; /* Counts the number of characters between double quotes */
-    int quotes = 0; /* Number of double quotes encountered */
-    
-    /* Continue this function only if there is 1 argument to the .string
-        If it is too little we raise error */
-    if (token_count == start_index) {
-        raise_error_in_line(INVALID_STRING, line_num);
-        return FALSE;
-    }
-    
-    /* This loop counts the number of character between the first double quotes and the second
-    double quotes, if it encounters a third one than we raise error */
-    for(i=0; i < strlen(line); i++) {
-        if (quotes == 0) {
-            if(line[i] == '\"') {
-                quotes++;
-                continue;
-            }
-        }else if(quotes == 1){
-            if(line[i] == '\"') {
-                quotes++;
-            }else{
-                counter++;
-            }
-        }else if(line[i] == '\"') {
-            /* If we encounter a thid double quotes we raise invalid string error */
-            raise_error_in_line(INVALID_QUOTES, line_num);
-            break;
-        }
-    }
-    
-    /* Return counter + space for null character */
-    return ++counter;
-}
-
-/* Calculate the number of integers in a .data declaration. */
-static int calculate_integers(char** tokens, int token_count, int start_index) {
-    int i;
-    int counter = 0;
-    
-    for(i=start_index; i < token_count; i++) {
-        /* If a valid integer increment counter */
-        if (atoi(tokens[i]) || !strcmp(tokens[i], "0")) {
-            counter++;
-        }
-    }
-    
-    /* If no valid integers met, raise error */
-    if(counter == 0) {
-        raise_error_in_line(INVALID_DATA, line_num);
-    }
-    
-    return counter;
-}
-
-/* Check if a symbol (label) is already in the symbol table. */
-static int is_symbol_in_table(char** tokens, int index) {
-    char* copy;
-    int length;
-    int result;
-    
-    copy = utils_duplicate_string(tokens[index]);
-    length = strlen(copy);
-    
-    /* If the symbol ends with ':' we remove it */
-    if(copy[length - 1] == ':') {
-        copy[length - 1] = '\0';
-    }
-    
-    result = symbol_table_is_symbol_in(copy);
-    
-    /* Symbol alredy exists */
-    if(result != INVALID) {
-        raise_error_in_line(SYMBOL_ALREDY_EXISTS, line_num);
-    }
-    
-    free(copy);
-    return (result >= 0)? TRUE:FALSE;
-}
-
-/* This function calculates the amount of encoded lines required for the instruction */
-static int calculate_ic_length(char** tokens, int token_count, int is_symbol) {
-    int number_of_lines = 1; /* Atleast 1 line is required for the operation itself */
-    
-    if (is_symbol) {
-        /* If the line is (label:) (operation) (operand) (operand) */
-        if (token_count == 4) {
-            /* If both operands are register we need 1 extra line */
-            if (is_register(tokens[2]) && is_register(tokens[3])) {
-                number_of_lines++;
-            }else {
-                number_of_lines += 2;
-            }
-        }
-        
-        /* If the line is: (label:) (operation) (operand) */
-        if (token_count == 3) {
-            number_of_lines++;
-        }
-    } else {
-        /* If the line is: (operation) (operand) (operand) */ 
-        if(token_count == 3) {
-            if (is_register(tokens[1]) && is_register(tokens[2])) {
-                number_of_lines ++;
-            }else {
-                number_of_lines += 2;
-            }
-        }
-        
-        /* If the line is: (operation) (operand) */
-        if (token_count == 2) {
-            number_of_lines++;
-        }
-    }
-        
-    return number_of_lines;
-}
-
-/* Check if a token represents a valid register. */
-static int is_register(char* token) {
-    const char* registers[] = {"@r0", "@r1", "@r2", "@r3", "@r4", "@r5", "@r6", "@r7"};
-    int i;
-    
-    for(i=0; i < 8; i++) {
-        if(!strcmp(token, registers[i])) {
-            return TRUE;
-        }
-    }
-    return FALSE;
-}
-
-/* Check if a line indicates an .extern declaration. */
-static int is_extern(char** tokens, int is_symbol) {
-    if (!strcmp(tokens[is_symbol], ".extern")) {
-        if(is_symbol){
-            raise_warning_in_line(UNNECESSARY_SYMBOL, line_num);
-        }
-        return TRUE;
-    }
-    return FALSE;
-}
-
-/* Check if a line indicates an .entry declaration. */
-static int is_entry(char** tokens, int is_symbol) {
-    if(!strcmp(tokens[is_symbol], ".entry")) {
-        if(is_symbol) {
-            raise_warning_in_line(UNNECESSARY_SYMBOL, line_num);
-        }
-        return TRUE;
-    }
-    return FALSE;
-}
-
-/* Add extern symbols to the symbol table. */
-static void add_externs_to_table(char** tokens, int token_count, int is_symbol) {
-    int i;
-    int length;
-    
-    for(i=is_symbol + 1; i < token_count; i++) {
-        length = strlen(tokens[i]);
-        
-        /* Check if parameter is alredy an existing symbol and raise error if so */
-        if (is_symbol_in_table(tokens, i)) {
-            continue;
-        }
-        
-        /* Checks that parameter is a valid symbol name */
-        if (length >= MAX_LABEL_LENGTH || !isalpha(tokens[i][0])) {
-            raise_error_in_line(INVALID_LABEL, line_num);
-            continue;
-        }
-        
-        /* If parameter is valid append to symbol table */
-        symbol_table_append(tokens[i], EXTERN_TYPE, 0);
-    }
-}
-
-
-
-
-
-
-
-
-
-
-/*----------------------------------------------------
-Second pass phase of the assembler
-----------------------------------------------------*/
-
-/* 
-The second pass phase is the phase where we check for more complex errors in the file
-and create an initial translation of the lines into binary.
-*/
-int parser_second_pass(FILE* file, char* file_name) {
-    char input_line[MAX_LINE_LENGTH]; /* Current line being parsed */
-    int token_count; /* Amount of tokens */
-    char** tokens; /* Line divided into tokens */
-    int is_symbol; /* Is symbol flag*/
-    int i, index; /* Indices */
-    FILE* ext_file; /* Pointer to .ext file */
-    
-    /* If amount of lines required by instructions and data exceeds 924 we raise memory overflow error */
-    if (ic + dc > MEMORY_SIZE) {
-        raise_error(MEMORY_OVERFLOW);
-        return FALSE;
-    }
-    
-    ext_file = writer_open_file(file_name, ".ext"); /* Create new .ext file */
-    
-    /* Initialize line num and offset ic count */
-    line_num = 0;
-    ic = MEMORY_OFFSET;
-    
-    while(fgets(input_line, MAX_LINE_LENGTH, file)) {
-        line_num++;
-        /* Tokenize line */
-        tokens = utils_tokenize(input_line, &token_count, " ,\t\n\r");
-        
-        /* Check if there's a symbol declaration */
-        is_symbol = is_first_token_symbol(tokens, token_count);
-        
-        /* If .data declaration encode to proper location in memory */
-        if(is_data(tokens[is_symbol])) {
-            lexer_analyze_data(tokens, token_count, is_symbol);
-            utils_free_tokens(tokens, token_count);
-            continue;
-        }
-        
-        /* If .string declaration encode to proper location */
-        if(is_string(tokens[is_symbol])) {
-            lexer_analyze_string(input_line);
-            utils_free_tokens(tokens, token_count);
-            continue;
-        }
-        
-        /* If .extern declaration ignore */
-        if(is_extern(tokens, is_symbol)) {
-            utils_free_tokens(tokens, token_count);
-            continue;
-        }
-        
-        /* If .entry declaration */
-        if(is_entry(tokens, is_symbol)) {
-            /* For each parameter in the line we check if parameter is a non-external existing symbol*/
-            for(i=is_symbol+1; i < token_count; i++) {
-                
-                if (symbol_table_is_extern(tokens[i])) {
-                    raise_error_in_line(ENTRY_DEFINED_AS_EXTERN, line_num);
-                }
-                
-                index = symbol_table_is_symbol_in(tokens[i]);
-                if(index == -1) raise_error_in_line(ENTRY_NOT_FOUND, line_num);
-                
-                /* Change symbol type to entry */
-                symbol_table_change_to_entry(tokens[i], index);
-            }
-            utils_free_tokens(tokens, token_count);
-            continue;
-        }
-        
-        /* If not .data/.string/.extern/.entry that means we encounter instruction line and encode it accordingly*/
-        lexer_analyze_operation(tokens, token_count, is_symbol, calculate_ic_length(tokens, token_count, is_symbol), ext_file);
-        /* Increment ic by length required */
-        ic += calculate_ic_length(tokens, token_count, is_symbol);
-        utils_free_tokens(tokens, token_count);
-    }
-        
-    /* If program handled errors or extern table is empty we remove the .ext file */
-    reader_close_file(ext_file);
-    
-    ext_file = reader_open_file(file_name, ".ext");
-    if(errors || (fgetc(ext_file)) == EOF) {
-        printf("Removing EXT file...\n");
-        writer_remove_file(file_name, ".ext");
-    }
-    
-    reader_close_file(ext_file);
-    return (errors == 0)? TRUE:FALSE;
+#include "parser.h"
+#include "utils.h"
+#include "error.h"
+#include "writer.h"
+#include "reader.h"
+#include "constants.h"
+#include "symbol_table.h"
+#include "macro_table.h"
+#include "translator.h"
+#include "lexer.h"
+#include "line_table.h"
+#include "scanner.h"
+#include "line_mask.h"
+#include "fixup_table.h"
+#include "image.h"
+#include "context.h"
+#include "batch.h"
+
+/*---------------------------------------------------------- 
+Pre-Assembly phase of the parser
+----------------------------------------------------------*/
+
+/* Check if the line contains no tokens (empty line). */
+static int is_empty_line(char*);
+
+/* Check if the line is a comment (starts with a semicolon ';'). */
+static int is_comment(char*);
+
+/* Handle the procedure when inside a macro. */
+static int in_macro_procedure(assembler_ctx*, char*, char*);
+
+/* Handle the procedure when not inside a macro. */
+static int not_in_macro_procedure(assembler_ctx*, char*, char*, size_t, char*);
+
+/* Calculate the amount of words a macro's body is encoded to, or INVALID if it cannot be outlined. */
+static int calculate_outline_words(assembler_ctx*, int);
+
+/* Declare the labels and extern names of the line table in the symbol table. */
+static void declare_line_symbols(assembler_ctx*);
+
+/* Find the last instruction of the line table, or INVALID if it is not "stop" or "rts". */
+static int find_final_instruction(assembler_ctx*);
+
+/* Check if a name is a valid symbol name, without raising an error. */
+static int is_symbol_name(char*, size_t);
+
+/* Check if the first token is a valid symbol (label). */
+static int is_first_token_symbol(scanned_line*);
+
+
+/* Assemble the input file into the line table. 
+    Return 1 if successful, and 0 otherwise */
+int parser_assemble_file(assembler_ctx* ctx, FILE* file){
+    size_t capacity = MAX_LINE_LENGTH; /* Amount of chars allocated for the line, which may be of any length */
+    size_t name_capacity = MAX_LINE_LENGTH; /* Amount of chars allocated for name */
+    char* input_line; /* Current line being processed */
+    char* name; /* Room for a null terminated copy of a token of the line */
+    
+    char* first_token; /* First token of the line, inside input_line */
+    size_t first_length; /* Length of the first token */
+    
+    int in_macro = 0; /* Flag indicating if currently inside a macro */
+    
+    input_line = (char*)malloc(capacity);
+    name = (char*)malloc(capacity);
+    
+    if(input_line == NULL || name == NULL){
+        raise_error(MEMORY_ERROR);
+        exit(FATAL_ERROR);
+    }
+    
+	ctx->line_num = 0; /* Initialize current line num to 1 */
+    ctx->errors = 0; /* Initialize error count to zero */
+    
+    while(reader_read_line(file, &input_line, &capacity) > 0){
+        /* Keep room for a copy of any token of the line */
+        if(name_capacity < capacity){
+            name_capacity = capacity;
+            name = (char*)realloc(name, name_capacity);
+            
+            if(name == NULL){
+                raise_error(MEMORY_ERROR);
+                exit(FATAL_ERROR);
+            }
+        }
+        
+        /* Find the first token without copying the line */
+        first_token = utils_next_token(input_line, SPACE_DELIMITERS, &first_length);
+		ctx->line_num++;
+        
+		
+        if(is_empty_line(first_token))
+            continue;
+        
+        if(is_comment(first_token))
+            continue;
+        
+        /* Check if currently inside a macro or not, initiate proper procedure, and update the 'in_macro' flag */
+        if(in_macro)
+            in_macro = in_macro_procedure(ctx, input_line, first_token);
+        else
+            in_macro = not_in_macro_procedure(ctx, input_line, first_token, first_length, name);
+    }
+    
+    context_message(ctx, "End of file\n");
+    free(input_line);
+    free(name);
+    
+    /* Return TRUE if there are no errors, FALSE otherwise */
+    return (ctx->errors == 0) ? TRUE : FALSE;
+}
+
+
+
+
+/* Handle the procedure when inside a macro.
+ * Returns:
+ *  - TRUE if the procedure continues inside a macro, FALSE if 'endmcro' is found.
+ */
+static int in_macro_procedure(assembler_ctx* ctx, char* input_line, char* first_token){
+    /* Assuming 'endmcro' declaration is valid, and is the only token in the input line */
+    /* If we reach 'endmcro', return FALSE to indicate the end of the macro */
+    if(!strncmp(first_token, "endmcro", 7)){
+        /* If there are tokens other than 'endmcro', display an error */
+        if(utils_count_tokens(input_line, SPACE_DELIMITERS) != 1){
+            raise_error_in_line(ctx, INVALID_ENDMCRO, ctx->line_num);
+        }
+        return FALSE;
+    }
+    
+    /* Merge tokens into a single line in place, which is never longer than the input line */
+    utils_normalize_spaces(input_line, input_line, SPACE_DELIMITERS, FALSE);
+    macro_table_append_to_last_macro(ctx, input_line);
+    
+    return TRUE; /* Continue in the macro procedure */
+}
+
+
+/* Handle the procedure when not inside a macro.
+ * Returns:
+ *  - TRUE if the procedure continues not inside a macro, FALSE if a 'mcro' is found.
+ */
+static int not_in_macro_procedure(assembler_ctx* ctx, char* input_line, char* first_token, size_t first_length, char* name){
+    char* title; /* Macro title, inside input_line */
+    size_t title_length;
+    int index_to_macro;
+    
+    /* If 'mcro' declaration is found */
+    if(!strncmp(first_token, "mcro", 4)){
+        title = utils_next_token(first_token + first_length, SPACE_DELIMITERS, &title_length);
+        
+        /* A declaration without a title has nothing to add to the table */
+        if(title == NULL){
+            raise_error_in_line(ctx, INVALID_MCRO, ctx->line_num);
+            return TRUE;
+        }
+        
+        memcpy(name, title, title_length);
+        name[title_length] = '\0';
+        
+        /* If there are not exactly 2 tokens in line(mcro and title), display an error */
+        if (utils_count_tokens(input_line, SPACE_DELIMITERS) != 2 || error_invalid_keyword(ctx, name)) {
+            raise_error_in_line(ctx, INVALID_MCRO, ctx->line_num);
+        }
+        
+        macro_table_add_macro(ctx, name);
+        return TRUE;
+    }
+    
+	/* Check if current token exists as a macro in the table */
+    memcpy(name, first_token, first_length);
+    name[first_length] = '\0';
+    index_to_macro = macro_table_is_macro_in(ctx, name);
+	
+    if (index_to_macro != -1) {
+        /* Append macro's info to the line table and remember where it was expanded */
+        macro_table_record_expansion(ctx, index_to_macro, line_table_get_length(ctx));
+        line_table_append(ctx, macro_table_get_mcr_info(ctx, index_to_macro), macro_table_get_mcr_info_length(ctx, index_to_macro));
+        return FALSE; /* Continue not in the macro procedure */
+    }
+    
+    /* Copy the line with its tokens separated by single spaces straight into the line table */
+    line_table_append_normalized(ctx, input_line, SPACE_DELIMITERS);
+    return FALSE; /* Continue not in the macro procedure */
+}
+
+
+
+
+
+/* Outline macros expanded more than 'threshold' times into subroutines.
+ * Every expansion of an outlined macro becomes a 'jsr' to its title, and the body is
+ * appended once to the end of the line table, labeled by the title and ended by 'rts'.
+ * A macro is outlined only if its body has no labels, directives or 'rts', its title
+ * is free to be used as a label, and the outlining saves words.
+ * Returns:
+ *  - The total amount of words saved.
+ */
+int parser_outline_macros(assembler_ctx* ctx, int threshold){
+    char line[MAX_LINE_LENGTH + MAX_LABEL_LENGTH]; /* Line being built */
+    int* uses; /* Amount of expansions of each macro */
+    int* words; /* Words each macro's body is encoded to, INVALID if not outlined */
+    int macros = macro_table_get_length(ctx);
+    int i, j, index, body_lines, saved, total_saved = 0;
+    int final; /* Line of the last instruction, the program never runs past it */
+    
+    uses = (int*)calloc(macros + 1, sizeof(int));
+    words = (int*)malloc((macros + 1) * sizeof(int));
+    
+    if(uses == NULL || words == NULL){
+        raise_error(MEMORY_ERROR);
+        exit(FATAL_ERROR);
+    }
+    
+    for(i=0; i < macro_table_get_expansions_length(ctx); i++)
+        uses[macro_table_get_expansion_macro(ctx, i)]++;
+    
+    /* The subroutines are appended after the last line, so the program must end before them */
+    final = find_final_instruction(ctx);
+    if(final == INVALID){
+        context_message(ctx, "Size optimization skipped, the last instruction is not stop or rts\n");
+        free(uses);
+        free(words);
+        return 0;
+    }
+    
+    /* The last instruction must stay in place, a macro expanded around it is not outlined */
+    for(i=0; i < macro_table_get_expansions_length(ctx); i++){
+        index = macro_table_get_expansion_macro(ctx, i);
+        body_lines = utils_count_lines(macro_table_get_mcr_info(ctx, index));
+        
+        if(macro_table_get_expansion_line(ctx, i) <= final && final < macro_table_get_expansion_line(ctx, i) + body_lines)
+            uses[index] = 0;
+    }
+    
+    /* A title may not clash with a label or an extern name, the table is dropped before the pass */
+    symbol_table_init(ctx);
+    declare_line_symbols(ctx);
+    
+    /* Choose the macros to outline */
+    for(i=0; i < macros; i++){
+        words[i] = INVALID;
+        
+        if(uses[i] <= threshold)
+            continue;
+        
+        j = calculate_outline_words(ctx, i);
+        if(j == INVALID)
+            continue;
+        
+        /* Every call takes 2 words (jsr and address), the subroutine takes the body and 1 word for rts */
+        saved = uses[i] * j - (uses[i] * 2 + j + 1);
+        if(saved <= 0)
+            continue;
+        
+        words[i] = j;
+        total_saved += saved;
+        context_message(ctx, "Outlined macro ");
+        context_message(ctx, macro_table_get_mcr_title(ctx, i));
+        context_message(ctx, ": ");
+        writer_buffer_add_int(ctx->messages, uses[i]);
+        context_message(ctx, " expansions, saved ");
+        writer_buffer_add_int(ctx->messages, saved);
+        context_message(ctx, " words\n");
+    }
+    
+    symbol_table_free(ctx);
+    
+    if(total_saved == 0){
+        free(uses);
+        free(words);
+        return 0;
+    }
+    
+    /* Replace each expansion of an outlined macro with a call */
+    for(i=0; i < macro_table_get_expansions_length(ctx); i++){
+        index = macro_table_get_expansion_macro(ctx, i);
+        if(words[index] == INVALID)
+            continue;
+        
+        sprintf(line, "jsr %s ", macro_table_get_mcr_title(ctx, index));
+        line_table_set_line(ctx, macro_table_get_expansion_line(ctx, i), line);
+        
+        body_lines = utils_count_lines(macro_table_get_mcr_info(ctx, index));
+        for(j=1; j < body_lines; j++)
+            line_table_remove_line(ctx, macro_table_get_expansion_line(ctx, i) + j);
+    }
+    line_table_compact(ctx);
+    
+    /* Append each outlined body once as a subroutine */
+    for(i=0; i < macros; i++){
+        if(words[i] == INVALID)
+            continue;
+        
+        /* Label the first line of the body */
+        sprintf(line, "%s: ", macro_table_get_mcr_title(ctx, i));
+        line_table_append(ctx, line, strlen(line));
+        line_table_append(ctx, macro_table_get_mcr_info(ctx, i), macro_table_get_mcr_info_length(ctx, i));
+        line_table_append(ctx, "rts \n", 5);
+    }
+    
+    context_message(ctx, "Size optimization saved ");
+    writer_buffer_add_int(ctx->messages, total_saved);
+    context_message(ctx, " words\n");
+    free(uses);
+    free(words);
+    return total_saved;
+}
+
+/* Calculate the amount of words the body of a macro is encoded to.
+ * Returns:
+ *  - The amount of words, or INVALID if the macro cannot be outlined.
+ */
+static int calculate_outline_words(assembler_ctx* ctx, int index){
+    char line[MAX_LINE_LENGTH]; /* Current line of the body */
+    scanned_line scan; /* Tokens of the current line */
+    scan_buffer buffer; /* Storage of the scanned line */
+    int total = 0;
+    char* body = macro_table_get_mcr_info(ctx, index);
+    char* title = macro_table_get_mcr_title(ctx, index);
+    size_t length = strlen(title);
+    
+    /* The title is used as the subroutine's label */
+    if(body[0] == '\0' || !is_symbol_name(title, length) || symbol_table_find(ctx, title, length) != INVALID)
+        return INVALID;
+    
+    while(*body != '\0'){
+        length = strcspn(body, "\n");
+        if(length >= MAX_LINE_LENGTH)
+            return INVALID;
+        
+        memcpy(line, body, length);
+        line[length] = '\0';
+        body += length + (body[length] == '\n');
+        
+        scanner_scan_line(&scan, buffer.text, buffer.tokens, line);
+        
+        /* Labels, directives and returns would change meaning inside a subroutine */
+        if(is_first_token_symbol(&scan) || scan.tokens[0].kind == TOKEN_DIRECTIVE || scan.tokens[0].word == KEYWORD_RTS)
+            return INVALID;
+        
+        total += lexer_count_words(&scan, FALSE);
+    }
+    
+    return total;
+}
+
+/* Declare every label and every name of an .extern declaration in the line table
+ * in the symbol table, so the title of an outlined macro can be checked against them.
+ * The lines are normalized, so their tokens are separated by single spaces.
+ */
+static int find_final_instruction(assembler_ctx* ctx){
+    char* line;
+    size_t length;
+    keyword word;
+    int i;
+    
+    for(i=line_table_get_length(ctx) - 1; i >= 0; i--){
+        line = line_table_get_line(ctx, i);
+        line += strspn(line, SPACE_DELIMITERS);
+        length = strcspn(line, SPACE_DELIMITERS);
+        
+        /* Skip the label of the line */
+        if(length > 0 && line[length-1] == ':'){
+            line += length + strspn(line + length, SPACE_DELIMITERS);
+            length = strcspn(line, SPACE_DELIMITERS);
+        }
+        
+        /* Directives and lines with only a label take no instruction words */
+        if(length == 0 || line[0] == '.')
+            continue;
+        
+        word = scanner_classify_keyword(line, (int)length);
+        return (word == KEYWORD_STOP || word == KEYWORD_RTS) ? i : INVALID;
+    }
+    
+    return INVALID;
+}
+
+static void declare_line_symbols(assembler_ctx* ctx){
+    char name[MAX_LABEL_LENGTH]; /* Null terminated copy of the current name */
+    char* line;
+    size_t length;
+    int i;
+    
+    for(i=0; i < line_table_get_length(ctx); i++){
+        line = line_table_get_line(ctx, i);
+        length = strcspn(line, SPACE_DELIMITERS);
+        
+        /* Skip the label of the line once it is declared */
+        if(length > 0 && line[length-1] == ':'){
+            if(length - 1 < MAX_LABEL_LENGTH){
+                memcpy(name, line, length - 1);
+                name[length-1] = '\0';
+                symbol_table_append(ctx, name, IC_TYPE, 0);
+            }
+            line += length + strspn(line + length, SPACE_DELIMITERS);
+            length = strcspn(line, SPACE_DELIMITERS);
+        }
+        
+        if(scanner_classify_keyword(line, (int)length) != KEYWORD_EXTERN)
+            continue;
+        
+        /* Declare the names after the directive, names longer than a label cannot clash with a title */
+        line += length;
+        while(*(line += strspn(line, SPACE_DELIMITERS ",")) != '\0'){
+            length = strcspn(line, SPACE_DELIMITERS ",");
+            if(length < MAX_LABEL_LENGTH){
+                memcpy(name, line, length);
+                name[length] = '\0';
+                symbol_table_append(ctx, name, EXTERN_TYPE, 0);
+            }
+            line += length;
+        }
+    }
+}
+
+/* Check if the line contains no tokens (empty line).
+ * Returns:
+ *  - TRUE if the line is empty, FALSE otherwise.
+ */
+static int is_empty_line(char* first_token){
+    return (first_token == NULL) ? TRUE : FALSE;
+}
+
+/* Check if the line is a comment (starts with a semicolon ';').
+ * Returns:
+ *  - TRUE if the line is a comment, FALSE otherwise.
+ */
+static int is_comment(char* first_token){
+    return (first_token[0] == ';') ? TRUE : FALSE;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*---------------------------------------------------------- 
+Single pass phase of the assembler
+----------------------------------------------------------*/
+
+/* Kinds of lines */
+#define LINE_INSTRUCTION 0
+#define LINE_DATA 1
+#define LINE_STRING 2
+#define LINE_EXTERN 3
+#define LINE_ENTRY 4
+#define LINE_EMPTY_LABEL 5 /* A label without a statement */
+#define LINE_SPACE 6
+
+/* Check if the first token is a valid symbol (label). */
+static int is_first_token_symbol(scanned_line*);
+
+/* Check if the token indicates a data declaration. */
+static int valid_symbol(assembler_ctx*, char*);
+
+/* Check if the token indicates a string declaration. */
+static int is_data(token*);
+
+/* Calculate the number of characters needed for a string. */
+static int is_string(token*);
+
+/* Check if the token indicates a space declaration. */
+static int is_space(token*);
+
+/* Calculate the length (number of rows) required for the instruction's encoding. */
+static int is_symbol_in_table(assembler_ctx*, scanned_line*, int);
+
+/* Check if a line indicates an .entry declaration. */
+static int is_extern(token*);
+
+/* Add extern symbols to the symbol table. */
+static int is_entry(token*);
+
+/* Classify a scanned line into one of the line kinds. */
+static int classify_line(scanned_line*, int);
+
+/* Find the text after a directive in the line it was scanned from. */
+static char* directive_values(scanned_line*, int, char*);
+
+/* Perform the first pass of the assembly process. */
+static void add_externs_to_table(assembler_ctx*, scanned_line*, int);
+
+/* Record the labels of an .entry declaration to be checked once all symbols are declared. */
+static void add_entries_to_fixups(assembler_ctx*, scanned_line*, int);
+
+/* Reset the counters of the file before its lines are assembled. */
+static void start_pass(assembler_ctx*);
+
+/* Assemble a range of lines, error checking and encoding each one. */
+static void assemble_lines(assembler_ctx*, int, int);
+
+/* Check the memory and resolve the fixups once all lines are assembled. */
+static int finish_pass(assembler_ctx*);
+
+/* Assemble the lines in chunks on threads and merge them, FALSE if they cannot be merged. */
+static int split_lines(assembler_ctx*, int);
+
+/* Assemble a single chunk of the lines. */
+static void assemble_chunk(int, void*);
+
+/* Represents the chunks of a split pass, shared by the threads */
+typedef struct ChunkData {
+	assembler_ctx** parts; /* Context of each chunk */
+	int chunks; /* Amount of chunks */
+} chunk_data;
+
+/* Represents the storage a line is scanned into, reused by every line of a pass and grown for longer lines */
+typedef struct LineStorage {
+	char* text; /* Scanned copy of the line */
+	size_t text_capacity; /* Amount of chars allocated for text */
+	token* tokens; /* Tokens of the line */
+	int tokens_capacity; /* Amount of tokens allocated */
+} line_storage;
+
+/* Error check and encode a single line, FALSE if its words are not kept. */
+static int assemble_line(assembler_ctx*, char*, line_storage*);
+
+/* Make sure the storage of the scanned line can hold a line of a given length. */
+static void reserve_storage(line_storage*, size_t);
+
+
+/* 
+This single pass is responsible for error checking in the file, the creation of a symbol table
+and the translation of the lines into binary. Every line is scanned and encoded once, labels used
+as operands and declared as entries are recorded as fixups and resolved once all symbols are declared.
+*/
+int parser_single_pass(assembler_ctx* ctx) {
+    start_pass(ctx);
+    assemble_lines(ctx, 0, line_table_get_length(ctx));
+    return finish_pass(ctx);
+}
+
+/*
+This pass does the same as the single pass with the lines split into chunks, each assembled on a
+thread of its own from ic and dc 0 into tables of its own. The chunks are then merged in order,
+moving each one by the words of the chunks before it, and the fixups are resolved as in the single pass.
+A chunk can only tell the labels it declares, so if any chunk has errors or declares a label of an
+earlier chunk the lines are assembled again in a single pass, and the errors are the same.
+*/
+int parser_split_pass(assembler_ctx* ctx, int chunks) {
+    int length = line_table_get_length(ctx);
+    
+    /* Small files are not worth the threads */
+    if(chunks > length / SPLIT_MIN_LINES) {
+        chunks = length / SPLIT_MIN_LINES;
+    }
+    
+    if(chunks < 2) {
+        return parser_single_pass(ctx);
+    }
+    
+    start_pass(ctx);
+    line_mask_init();
+    
+    if(!split_lines(ctx, chunks)) {
+        /* Start over with empty tables */
+        symbol_table_free(ctx);
+        symbol_table_init(ctx);
+        image_free(ctx);
+        image_init(ctx, MEMORY_SIZE, MEMORY_SIZE);
+        assemble_lines(ctx, 0, length);
+    }
+    
+    return finish_pass(ctx);
+}
+
+/*
+Resets the counters of the file and prepares the fixups.
+*/
+static void start_pass(assembler_ctx* ctx) {
+	ctx->ic = 0; /* Initialize ic to 0 */
+    ctx->dc = 0; /* Initialize dc to 0 */
+	ctx->line_num = 0; /* Initialize number of line to 0 */
+	ctx->errors = 0; /* Initialize errors to 0 */
+    
+    context_message(ctx, "Starting error handling...\nBuilding symbol table and translating lines...\n");
+    fixup_table_init(ctx);
+}
+
+/*
+Assembles the lines from a first index up to a last one, numbered from the line number of the context.
+A line whose label is already declared or invalid is checked for errors but takes no memory, so the
+addresses of the lines after it are the same as if it was left out.
+*/
+static void assemble_lines(assembler_ctx* ctx, int first, int last) {
+	line_storage storage; /* Storage of the scanned line, starting with room for a line of the maximal length */
+	int i; /* Index of the current line */
+	int ic, dc; /* Counters before the current line */
+	
+	storage.text_capacity = MAX_LINE_LENGTH;
+	storage.text = (char*)malloc(sizeof(char) * storage.text_capacity);
+	storage.tokens_capacity = SCANNED_TOKENS(MAX_LINE_LENGTH);
+	storage.tokens = (token*)malloc(sizeof(token) * storage.tokens_capacity);
+	
+	if(storage.text == NULL || storage.tokens == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	for(i=first; i < last; i++) {
+        ctx->line_num++;
+        ic = ctx->ic;
+        dc = ctx->dc;
+        
+        if(!assemble_line(ctx, line_table_get_line(ctx, i), &storage)) {
+            ctx->ic = ic;
+            ctx->dc = dc;
+            image_rewind(ctx, ic, dc);
+        }
+	}
+	
+	free(storage.text);
+	free(storage.tokens);
+}
+
+/*
+Error checks a single line and encodes it. Returns FALSE if the words of the line are not kept,
+since its label is already declared or invalid.
+*/
+static int assemble_line(assembler_ctx* ctx, char* line, line_storage* storage) {
+	scanned_line scan; /* Line divided into tokens */
+	
+	int is_symbol; /* Is Symbol / Label  flag*/
+	int declared; /* Flag if the label of the line is new and valid, and is added to the symbol table */
+	int kept; /* Flag if the words of the line are kept, FALSE if its label is rejected */
+	int kind; /* Kind of the line */
+	instruction ir; /* Parsed instruction line */
+	
+    /* Scan line to different tokens, over the line scanned before it */
+    reserve_storage(storage, strlen(line));
+    scanner_scan_line(&scan, storage->text, storage->tokens, line);
+    
+    /* Check if first token is symbol then turn flag to TRUE */
+    is_symbol = is_first_token_symbol(&scan);
+    kind = classify_line(&scan, is_symbol);
+    
+    /* If there is a symbol declaration and it already exists or is invalid, raise error.
+        The rest of the line is still translated to find its errors */
+    declared = FALSE;
+    kept = TRUE;
+    if (is_symbol) {
+        declared = !is_symbol_in_table(ctx, &scan, 0) && valid_symbol(ctx, scan.tokens[0].text);
+        kept = declared;
+        
+        /* If its an empty symbol declaration raise error */
+        if(declared && kind == LINE_EMPTY_LABEL) {
+            raise_error_in_line(ctx, EMPTY_LABEL, ctx->line_num);
+        }
+    }
+    
+    if(kind == LINE_EMPTY_LABEL) {
+        return kept;
+    }
+    
+    /* If its a .data declaration */
+    if(kind == LINE_DATA) {
+        /* If its also a symbol add it to symbol table */
+        if(declared) {
+            symbol_table_append(ctx, scan.tokens[0].text, DC_TYPE, ctx->dc);
+        }
+        
+        /* Encode the data and count the rows it takes */
+        ctx->dc += lexer_analyze_data(ctx, directive_values(&scan, is_symbol, line));
+        return kept;
+    }
+    
+    /* If its a .space declaration */
+    if(kind == LINE_SPACE) {
+        /* If its also a symbol add it to symbol table */
+        if(declared) {
+            symbol_table_append(ctx, scan.tokens[0].text, DC_TYPE, ctx->dc);
+        }
+        
+        /* Reserve the requested amount of rows */
+        ctx->dc += lexer_analyze_space(ctx, directive_values(&scan, is_symbol, line));
+        return kept;
+    }
+    
+    /* If its a .string declaration */
+    if(kind == LINE_STRING) {
+        /* If its also a symbol, add to symbol table */
+        if(declared){
+            symbol_table_append(ctx, scan.tokens[0].text, DC_TYPE, ctx->dc);
+        }
+        
+        /* The string must be given, encode it and count the rows it takes */
+        if(scan.count == is_symbol + 1) {
+            raise_error_in_line(ctx, INVALID_STRING, ctx->line_num);
+            return kept;
+        }
+        ctx->dc += lexer_analyze_string(ctx, line);
+        return kept;
+    }
+    
+    /* If its extern we handle it in a seperate function */
+    if(kind == LINE_EXTERN) {
+        if(is_symbol) {
+            raise_warning_in_line(ctx, UNNECESSARY_SYMBOL, ctx->line_num);
+        }
+        add_externs_to_table(ctx, &scan, is_symbol);
+        return kept;
+    }
+    
+    /* If its .entry declaration its labels are checked once all symbols are declared */
+    if(kind == LINE_ENTRY) {
+        if(is_symbol) {
+            raise_warning_in_line(ctx, UNNECESSARY_SYMBOL, ctx->line_num);
+        }
+        add_entries_to_fixups(ctx, &scan, is_symbol);
+        return kept;
+    }
+    
+    /* If non of the ifs so far are met, that means the line is an instruction */
+    
+    /* If its symbol than add it to the symbol table as instruction */
+    if(declared) {
+        symbol_table_append(ctx, scan.tokens[0].text, IC_TYPE, ctx->ic);
+    }
+    
+    /* An instruction with initial errors is not encoded, so its operands raise no further errors,
+       but it keeps its words so the addresses of the following lines do not move */
+    if(!error_check_instruction(ctx, &scan, is_symbol)) {
+        ctx->ic += lexer_count_words(&scan, is_symbol);
+        return kept;
+    }
+    
+    /* Encode the instruction at the current ic and increment IC with the total lines it requires */
+    lexer_parse_operation(ctx, &scan, is_symbol, &ir);
+    lexer_analyze_operation(ctx, &ir);
+    ctx->ic += ir.words;
+    return kept;
+}
+
+/*
+Doubles the text and the tokens of the storage until a line of a given length fits. Short lines
+keep MIN_SCANNED_TOKENS tokens, so missing operands read as empty tokens.
+*/
+static void reserve_storage(line_storage* storage, size_t length) {
+    if(length + 1 > storage->text_capacity) {
+        while(length + 1 > storage->text_capacity) {
+            storage->text_capacity *= 2;
+        }
+        
+        storage->text = (char*)realloc(storage->text, storage->text_capacity * sizeof(char));
+    }
+    
+    if(SCANNED_TOKENS(length) > storage->tokens_capacity) {
+        while(SCANNED_TOKENS(length) > storage->tokens_capacity) {
+            storage->tokens_capacity *= 2;
+        }
+        
+        storage->tokens = (token*)realloc(storage->tokens, storage->tokens_capacity * sizeof(token));
+    }
+    
+    if(storage->text == NULL || storage->tokens == NULL) {
+        raise_error(MEMORY_ERROR);
+        exit(FATAL_ERROR);
+    }
+}
+
+/*
+Checks the memory, updates the addresses of the symbols and resolves the fixups once all lines are assembled.
+*/
+static int finish_pass(assembler_ctx* ctx) {
+    /* If amount of lines required by instructions and data exceeds 924 we raise memory overflow error */
+    if (ctx->ic + ctx->dc > MEMORY_SIZE) {
+        raise_error_in_file(ctx, MEMORY_OVERFLOW);
+        fixup_table_free(ctx);
+        return FALSE;
+    }
+    
+    /* Update symbol addresses (since memory begins at 100 and data begins at 100 + IC) */
+    symbol_table_update_addresses(ctx, ctx->ic);
+    
+    /* Every symbol address is final, patch the label operands and mark the entries */
+    fixup_table_apply(ctx);
+    fixup_table_free(ctx);
+    
+    /* Debugging purposes */
+    context_message(ctx, "Symbol Table:\n");
+    symbol_table_print(ctx);
+    context_message(ctx, "\n\n");
+    
+    return (ctx->errors == 0)? TRUE:FALSE;
+}
+
+/*
+Assembles the chunks of lines on threads and merges them into the tables of the file, returns
+FALSE if they cannot be merged.
+*/
+static int split_lines(assembler_ctx* ctx, int chunks) {
+    assembler_ctx** parts = (assembler_ctx**)malloc(sizeof(assembler_ctx*) * chunks);
+    chunk_data data; /* Chunks shared with the threads */
+    int merged = TRUE; /* Flag if the chunks are merged */
+    int ic = 0, dc = 0; /* Words of the chunks merged so far */
+    int i;
+    
+    if(parts == NULL) {
+        raise_error(MEMORY_ERROR);
+        exit(FATAL_ERROR);
+    }
+    
+    /* Every chunk reads the lines of the file and fills tables of its own */
+    for(i=0; i < chunks; i++) {
+        parts[i] = context_new();
+        parts[i]->lines = ctx->lines;
+        parts[i]->line_num = (int)((long)line_table_get_length(ctx) * i / chunks);
+        symbol_table_init(parts[i]);
+        image_init(parts[i], MEMORY_SIZE, MEMORY_SIZE);
+        fixup_table_init(parts[i]);
+    }
+    
+    data.parts = parts;
+    data.chunks = chunks;
+    batch_run(chunks, assemble_chunk, &data);
+    
+    /* The symbols are merged first, so nothing else is merged if a label is declared in two chunks */
+    for(i=0; i < chunks && merged; i++) {
+        merged = parts[i]->errors == 0 && symbol_table_merge(ctx, parts[i], ic, dc);
+        ic += parts[i]->ic;
+        dc += parts[i]->dc;
+    }
+    
+    if(merged) {
+        ic = 0;
+        for(i=0; i < chunks; i++) {
+            image_merge(ctx, parts[i]);
+            fixup_table_merge(ctx, parts[i], ic);
+            context_append(ctx, parts[i]);
+            ic += parts[i]->ic;
+        }
+        
+        ctx->ic = ic;
+        ctx->dc = dc;
+        ctx->line_num = line_table_get_length(ctx);
+    }
+    
+    /* The lines belong to the file */
+    for(i=0; i < chunks; i++) {
+        parts[i]->lines = NULL;
+        context_free(parts[i]);
+    }
+    
+    free(parts);
+    return merged;
+}
+
+/*
+Assembles a chunk of the lines, from the first line of the chunk up to the first line of the next one.
+*/
+static void assemble_chunk(int index, void* argument) {
+    chunk_data* data = (chunk_data*)argument;
+    assembler_ctx* part = data->parts[index];
+    int last = (int)((long)line_table_get_length(part) * (index + 1) / data->chunks);
+    
+    assemble_lines(part, part->line_num, last);
+}
+
+/* Validate if a symbol (label) is valid. */
+static int valid_symbol(assembler_ctx* ctx, char* name) {
+    size_t length = strlen(name);
+    size_t name_length = length;
+    
+    /* Leave out the trailing ':' if present */
+    if(name[length-1] == ':') {
+        name_length--;
+    }
+    
+    /* If symbol is too long or doesnt start with alphabetic letter or is a reserved 
+    keyword, than raise error. */
+    if (length >= MAX_LABEL_LENGTH || !is_symbol_name(name, name_length)) {
+        raise_error_in_line(ctx, INVALID_LABEL, ctx->line_num);
+        return FALSE;
+    }
+    
+    return TRUE;
+}
+
+/* Check if a name of a given length starts with an alphabetic letter, fits in a label
+ * and is not a reserved keyword. */
+static int is_symbol_name(char* name, size_t length) {
+    return length > 0 && length < MAX_LABEL_LENGTH && isalpha(name[0]) &&
+        scanner_classify_keyword(name, (int)length) == KEYWORD_NONE;
+}
+
+/* Check if the first token in a line is a symbol (label). */
+static int is_first_token_symbol(scanned_line* scan) {
+    /* If last char of the string is ':' than return true */
+    if (scan->tokens[0].kind == TOKEN_LABEL) {
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* Check if a token represents a .data declaration. */
+static int is_data(token* current) {
+    return current->word == KEYWORD_DATA;
+}
+
+/* Check if a token represents a .space declaration. */
+static int is_space(token* current) {
+    return current->word == KEYWORD_SPACE;
+}
+
+/* Check if a token represents a .string declaration. */
+static int is_string(token* current) {
+    return current->word == KEYWORD_STRING;
+}
+
+/* Find the values of a directive, the text after it in the line it was scanned from. */
+static char* directive_values(scanned_line* scan, int is_symbol, char* line) {
+    token* directive = &scan->tokens[is_symbol];
+    
+    /* The scanned copy keeps the offsets of the line */
+    return line + (directive->text - scan->text) + directive->length;
+}
+
+/* Check if a symbol (label) is already in the symbol table. */
+static int is_symbol_in_table(assembler_ctx* ctx, scanned_line* scan, int index) {
+    token* name = &scan->tokens[index];
+    int length = name->length;
+    int result;
+    
+    /* If the symbol ends with ':' we leave it out */
+    if(name->text[length - 1] == ':') {
+        length--;
+    }
+    
+    result = symbol_table_find(ctx, name->text, (size_t)length);
+    
+    /* Symbol alredy exists */
+    if(result != INVALID) {
+        raise_error_in_line(ctx, SYMBOL_ALREDY_EXISTS, ctx->line_num);
+    }
+    
+    return (result >= 0)? TRUE:FALSE;
+}
+
+/* Check if a token represents an .extern declaration. */
+static int is_extern(token* current) {
+    return current->word == KEYWORD_EXTERN;
+}
+
+/* Check if a token represents an .entry declaration. */
+static int is_entry(token* current) {
+    return current->word == KEYWORD_ENTRY;
+}
+
+/* Classify a line by its statement, which follows the label if there is one. */
+static int classify_line(scanned_line* scan, int is_symbol) {
+    if(is_symbol && scan->count == 1) return LINE_EMPTY_LABEL;
+    if(is_data(&scan->tokens[is_symbol])) return LINE_DATA;
+    if(is_space(&scan->tokens[is_symbol])) return LINE_SPACE;
+    if(is_string(&scan->tokens[is_symbol])) return LINE_STRING;
+    if(is_extern(&scan->tokens[is_symbol])) return LINE_EXTERN;
+    if(is_entry(&scan->tokens[is_symbol])) return LINE_ENTRY;
+    
+    return LINE_INSTRUCTION;
+}
+
+/* Add extern symbols to the symbol table. */
+static void add_externs_to_table(assembler_ctx* ctx, scanned_line* scan, int is_symbol) {
+    int i;
+    int length;
+    
+    for(i=is_symbol + 1; i < scan->count; i++) {
+        length = scan->tokens[i].length;
+        
+        /* Check if parameter is alredy an existing symbol and raise error if so */
+        if (is_symbol_in_table(ctx, scan, i)) {
+            continue;
+        }
+        
+        /* Checks that parameter is a valid symbol name */
+        if (length >= MAX_LABEL_LENGTH || !isalpha(scan->tokens[i].text[0])) {
+            raise_error_in_line(ctx, INVALID_LABEL, ctx->line_num);
+            continue;
+        }
+        
+        /* If parameter is valid append to symbol table */
+        symbol_table_append(ctx, scan->tokens[i].text, EXTERN_TYPE, 0);
+    }
+}
+
+/* Record the labels of an .entry declaration, they are checked once all symbols are declared. */
+static void add_entries_to_fixups(assembler_ctx* ctx, scanned_line* scan, int is_symbol) {
+    int i;
+    
+    for(i=is_symbol + 1; i < scan->count; i++) {
+        fixup_table_add_entry(ctx, symbol_table_reference(ctx, scan->tokens[i].text, (size_t)scan->tokens[i].length), ctx->line_num);
+    }
 }
\ No newline at end of file
@@ -1,29 +1,41 @@
-#ifndef PARSER_H
-#define PARSER_H
-
-#include <stdio.h>
-#include <string.h>
-#include <ctype.h>
-
-/*
-* This function is responsible for pre-assembling the file, spreading macros and
-* ignore empty lines and comments and write .am file 
-*/
-int parser_assemble_file(FILE*, char*);
-
-/*
-* This function is responsible for initial error checking, making sure the
-* file can then be passed on to initial translation
-*/	
-void parser_first_pass(FILE*);
-
-/*
-* This function is responsible for more complex error checking, and initial
-* translation
-*/
-int parser_second_pass(FILE*, char*);
-
-
-
-
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "context.h"
+
+#define SPLIT_MIN_LINES 64 /* Least amount of lines in each chunk of a split pass */
+
+/*
+* This function is responsible for pre-assembling the file, spreading macros and
+* ignore empty lines and comments into the line table, the macros are kept in
+* the macro table
+*/
+int parser_assemble_file(assembler_ctx*, FILE*);
+
+/*
+* This function is responsible for outlining macros expanded more than a given
+* amount of times into subroutines, returns the amount of words saved
+*/
+int parser_outline_macros(assembler_ctx*, int);
+
+/*
+* This function is responsible for error checking, building the symbol table
+* and translating the file into the image in a single pass over its lines,
+* returns TRUE if there are no errors
+*/
+int parser_single_pass(assembler_ctx*);
+
+/*
+* This function does the same as parser_single_pass with the lines split into
+* an amount of chunks assembled at once, each by a thread of its own. The
+* output and the errors are the same as the single pass
+*/
+int parser_split_pass(assembler_ctx*, int);
+
+
+
+
 #endif
\ No newline at end of file
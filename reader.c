@@ -1,38 +1,70 @@
-#include "reader.h"
-#include "utils.h"
-#include "error.h"
-
-/* 
-Open a file with the specified file name and extension for reading.
-*/
-FILE* reader_open_file(char* file_name, const char* extension){
-    /* Add extension to file name */
-    char* full_file_name = utils_format_file_name(file_name, extension);
-    FILE* reader_file;
-    
-    printf("----------\nCurrent file: %s\n----------\n", full_file_name);
-    printf("Opening...\n");
-
-    reader_file = fopen(full_file_name, "r"); /* Open file */
-    
-    /* Check if exists */
-    if(!reader_file){
-        raise_error(CANT_READ_FILE);
-    }
-    else{
-        printf("Success!\n");
-    }
-    
-    /* Free name and returns file pointer */
-    free(full_file_name);
-    return reader_file;
-}
-
-/*
-Close the specified file.
-*/
-void reader_close_file(FILE* reader_file){
-    if(reader_file != NULL){
-        fclose(reader_file);
-    }
-}
+#include "reader.h"
+#include "utils.h"
+#include "error.h"
+#include "constants.h"
+#include <string.h>
+
+/* 
+Open a file with the specified file name and extension for reading.
+*/
+FILE* reader_open_file(assembler_ctx* ctx, char* file_name, const char* extension){
+    /* Add extension to file name */
+    char* full_file_name = utils_format_file_name(file_name, extension);
+    FILE* reader_file;
+    
+    context_message(ctx, "----------\nCurrent file: ");
+    context_message(ctx, full_file_name);
+    context_message(ctx, "\n----------\nOpening...\n");
+
+    reader_file = fopen(full_file_name, "r"); /* Open file */
+    
+    /* Check if exists */
+    if(!reader_file){
+        raise_error_in_file(ctx, CANT_READ_FILE);
+    }
+    else{
+        context_message(ctx, "Success!\n");
+    }
+    
+    /* Free name and returns file pointer */
+    free(full_file_name);
+    return reader_file;
+}
+
+/*
+Close the specified file.
+*/
+void reader_close_file(FILE* reader_file){
+    if(reader_file != NULL){
+        fclose(reader_file);
+    }
+}
+
+/*
+Read a whole line of any length, growing the buffer as needed.
+Returns the length of the line including its new line character, or 0 at end of file.
+*/
+size_t reader_read_line(FILE* reader_file, char** buffer, size_t* capacity){
+    size_t length = 0;
+    
+    while(fgets(*buffer + length, (int)(*capacity - length), reader_file) != NULL){
+        length += strlen(*buffer + length);
+        
+        /* The line ended or the file ended without a new line */
+        if((length > 0 && (*buffer)[length - 1] == '\n') || feof(reader_file))
+            return length;
+        
+        /* The buffer is full, double it and keep reading the same line */
+        if(length == *capacity - 1){
+            *capacity *= 2;
+            *buffer = (char*)realloc(*buffer, *capacity);
+            
+            if(*buffer == NULL){
+                raise_error(MEMORY_ERROR);
+                exit(FATAL_ERROR);
+            }
+        }
+    }
+    
+    return length;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "scanner.h"
+#include "line_mask.h"
+#include <string.h>
+
+/* This function returns the kind of a token */
+static int classify(char*, int, keyword);
+/* This function returns a keyword if the rest of a word matches it */
+static keyword match(char*, const char*, keyword);
+
+/* Mnemonics of the commands and their lengths by opcode, generated from the instruction set */
+#define ISA_COMMAND(mnemonic, name, operands, sources, destinations) #mnemonic,
+static const char* const mnemonics[AMOUNT_OF_COMMANDS] = { ISA_COMMANDS };
+#undef ISA_COMMAND
+
+#define ISA_COMMAND(mnemonic, name, operands, sources, destinations) sizeof(#mnemonic) - 1,
+static const unsigned char mnemonic_lengths[AMOUNT_OF_COMMANDS] = { ISA_COMMANDS };
+#undef ISA_COMMAND
+
+
+/*
+	This function scans a line into tokens. The delimiter mask of the line is
+	searched for the start and end of each token, and the delimiter ending a token
+	is replaced by a null character. Commas are not tokens, the commas between
+	tokens are counted in the comma mask.
+*/
+size_t scanner_scan_line(scanned_line* scan, char* text, token* tokens, char* line) {
+	line_mask mask;
+	int start, end;
+	int position = 0; /* Position after the last token */
+	int i;
+	
+	/* Copy the line */
+	line_mask_build(&mask, line);
+	memcpy(text, line, mask.length);
+	text[mask.length] = '\0';
+	
+	scan->text = text;
+	scan->tokens = tokens;
+	scan->count = 0;
+	
+	while(TRUE) {
+		/* A token starts at the first char which is not a delimiter and ends at the next delimiter */
+		start = line_mask_next_clear(&mask, mask.delimiters, position);
+		if(start == mask.length) break;
+		end = line_mask_next(&mask, mask.delimiters, start);
+		
+		scan->tokens[scan->count].text = text + start;
+		scan->tokens[scan->count].length = end - start;
+		scan->tokens[scan->count].commas = line_mask_count(mask.commas, position, start);
+		text[end] = '\0';
+		
+		scan->tokens[scan->count].word = scanner_classify_keyword(scan->tokens[scan->count].text, scan->tokens[scan->count].length);
+		scan->tokens[scan->count].kind = classify(scan->tokens[scan->count].text, scan->tokens[scan->count].length, scan->tokens[scan->count].word);
+		scan->count++;
+		position = end;
+	}
+	
+	/* Count the commas after the last token */
+	scan->trailing_commas = line_mask_count(mask.commas, position, mask.length);
+	line_mask_free(&mask);
+	
+	/* Missing operands read as empty tokens */
+	for(i = scan->count; i < MIN_SCANNED_TOKENS; i++) {
+		scan->tokens[i].text = "";
+		scan->tokens[i].length = 0;
+		scan->tokens[i].kind = TOKEN_OTHER;
+		scan->tokens[i].word = KEYWORD_NONE;
+		scan->tokens[i].commas = 0;
+	}
+	
+	return mask.length + 1;
+}
+
+/*
+This function returns the keyword spelled by a word. A word is compared to the text of
+a command only if it has its length and first char, other keywords are selected by the
+length and first chars of the word, so they are compared at most once.
+*/
+keyword scanner_classify_keyword(char* text, int length) {
+	int i;
+	
+	/* Commands are numbered by their opcode */
+	for(i = 0; i < AMOUNT_OF_COMMANDS; i++) {
+		if(mnemonic_lengths[i] == length && mnemonics[i][0] == text[0] && memcmp(text, mnemonics[i], length) == 0) {
+			return (keyword)i;
+		}
+	}
+	
+	switch(length) {
+		case 3:
+			if(text[0] == '@' && text[1] == 'r' && text[2] >= '0' && text[2] < '0' + AMOUNT_OF_REGISTERS) {
+				return (keyword)(KEYWORD_R0 + (text[2] - '0'));
+			}
+			return KEYWORD_NONE;
+		case 5: return match(text, ".data", KEYWORD_DATA);
+		case 6: return (text[1] == 'e') ? match(text, ".entry", KEYWORD_ENTRY) : match(text, ".space", KEYWORD_SPACE);
+		case 7: return (text[1] == 's') ? match(text, ".string", KEYWORD_STRING) : match(text, ".extern", KEYWORD_EXTERN);
+	}
+	return KEYWORD_NONE;
+}
+
+/*
+This function returns a keyword if a word of the keyword's length spells it
+*/
+static keyword match(char* text, const char* expected, keyword result) {
+	return (memcmp(text, expected, strlen(expected)) == 0) ? result : KEYWORD_NONE;
+}
+
+/*
+This function returns the kind of a token by its keyword and its first and last chars
+*/
+static int classify(char* text, int length, keyword word) {
+	char* digits = text;
+	
+	if(text[length - 1] == ':') return TOKEN_LABEL;
+	if(text[0] == '.') return TOKEN_DIRECTIVE;
+	if(text[0] == '"') return TOKEN_STRING;
+	
+	if(word >= KEYWORD_R0 && word <= KEYWORD_R7) {
+		return TOKEN_REGISTER;
+	}
+	
+	if(*digits == '-' || *digits == '+') digits++;
+	if(*digits >= '0' && *digits <= '9') return TOKEN_IMMEDIATE;
+	
+	if((text[0] >= 'a' && text[0] <= 'z') || (text[0] >= 'A' && text[0] <= 'Z')) return TOKEN_WORD;
+	
+	return TOKEN_OTHER;
+}
\ No newline at end of file
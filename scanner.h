@@ -0,0 +1,69 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include "constants.h"
+#include "isa.h"
+#include <stddef.h>
+
+/* Kinds of tokens recognized by the scanner */
+#define TOKEN_WORD 0 /* Mnemonic or symbol operand */
+#define TOKEN_LABEL 1 /* Word ending with ':' */
+#define TOKEN_DIRECTIVE 2 /* Word starting with '.' */
+#define TOKEN_REGISTER 3 /* One of @r0 to @r7 */
+#define TOKEN_IMMEDIATE 4 /* Number with an optional sign */
+#define TOKEN_STRING 5 /* Word starting with '"' */
+#define TOKEN_OTHER 6 /* Anything else */
+
+#define MIN_SCANNED_TOKENS 4 /* A label, an operation and 2 operands are read even if missing */
+#define SCANNED_TOKENS(length) ((length) / 2 + 1 + MIN_SCANNED_TOKENS) /* Most tokens stored for a line of a given length */
+
+/* Keywords of the assembly language, commands come first and are numbered by their opcode */
+#define ISA_COMMAND(mnemonic, name, operands, sources, destinations) KEYWORD_##name,
+typedef enum Keyword {
+	KEYWORD_NONE = -1,
+	ISA_COMMANDS
+	KEYWORD_R0, KEYWORD_R1, KEYWORD_R2, KEYWORD_R3, KEYWORD_R4, KEYWORD_R5, KEYWORD_R6, KEYWORD_R7,
+	KEYWORD_DATA, KEYWORD_STRING, KEYWORD_ENTRY, KEYWORD_EXTERN, KEYWORD_SPACE
+} keyword;
+#undef ISA_COMMAND
+
+/* Represents a view of a token inside a scanned line */
+typedef struct Token {
+	char* text; /* Null terminated token inside the scanned line */
+	int length; /* Amount of chars in the token */
+	int kind; /* Kind of the token */
+	keyword word; /* Keyword the token spells, KEYWORD_NONE if it is not a keyword */
+	int commas; /* Amount of commas between the previous token and this one */
+} token;
+
+/* Represents a line split into tokens, a view of the storage it was scanned into */
+typedef struct ScannedLine {
+	char* text; /* Copy of the line, with a null character after each token */
+	token* tokens; /* Views of the tokens inside text */
+	int count; /* Amount of tokens */
+	int trailing_commas; /* Amount of commas after the last token */
+} scanned_line;
+
+/* Represents storage for scanning a single line shorter than MAX_LINE_LENGTH */
+typedef struct ScanBuffer {
+	char text[MAX_LINE_LENGTH];
+	token tokens[SCANNED_TOKENS(MAX_LINE_LENGTH)];
+} scan_buffer;
+
+/*
+* This function scans a line of any length into tokens separated by spaces and
+* commas. The line is copied to the given text storage and split there, the
+* original line is not changed. The text storage needs room for the line and its
+* null character, the token storage needs room for SCANNED_TOKENS of its length.
+* Tokens after the last one, up to MIN_SCANNED_TOKENS, are empty.
+* Returns the amount of chars used in the text storage.
+*/
+size_t scanner_scan_line(scanned_line*, char*, token*, char*);
+
+/*
+* This function returns the keyword spelled by a given amount of chars,
+* or KEYWORD_NONE if they are not a keyword
+*/
+keyword scanner_classify_keyword(char*, int);
+
+#endif
\ No newline at end of file
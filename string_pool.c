@@ -0,0 +1,234 @@
+#include "string_pool.h"
+#include "utils.h"
+#include "constants.h"
+#include "error.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Represents a string in the pool */
+typedef struct PooledString {
+	char* text; /* Null terminated text, inside one of the arena's blocks */
+	size_t length; /* Amount of chars in the text */
+	unsigned long hash; /* Hash of the text */
+} pooled_string;
+
+/* Represents a block of the arena, the chars of the block follow it in memory */
+typedef struct Block {
+	struct Block* next; /* Previous block filled */
+	size_t used; /* Amount of chars handed out from the block */
+	size_t size; /* Amount of chars in the block */
+} block;
+
+struct StringPool {
+	struct PooledString* list; /* Strings of the pool, an ID is an index to the list */
+	int current_size;
+	int total_size;
+	
+	int* index; /* Open addressing index, each slot holds an ID or INVALID */
+	int index_size; /* Amount of slots in the index, always a power of 2 */
+	
+	struct Block* blocks; /* Block strings are currently bumped into, followed by older blocks */
+};
+
+
+/* This function returns the slot of a string in the index, or the empty slot it should be placed in */
+static int find_slot(string_pool*, char*, size_t, unsigned long);
+/* This function doubles the index and rehashes all strings into it */
+static void grow_index(string_pool*);
+/* This function hands out room for an amount of chars from the arena */
+static char* allocate(string_pool*, size_t);
+
+
+
+
+/*
+	This function allocates a new empty string pool
+*/
+string_pool* string_pool_new() {
+	int i;
+	string_pool* pool = (string_pool*)malloc(sizeof(string_pool));
+	
+	if(pool == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	pool->list = (pooled_string*)malloc(sizeof(pooled_string) * TABLE_BASE_SIZE);
+	pool->current_size = 0;
+	pool->total_size = TABLE_BASE_SIZE;
+	
+	pool->index = (int*)malloc(sizeof(int) * HASH_BASE_SIZE);
+	pool->index_size = HASH_BASE_SIZE;
+	
+	pool->blocks = NULL;
+	
+	if(pool->list == NULL || pool->index == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	for(i=0; i < pool->index_size; i++) {
+		pool->index[i] = INVALID;
+	}
+	
+	return pool;
+}
+
+/*
+	This function frees a string pool, all of its strings are released with their blocks
+*/
+void string_pool_free(string_pool* pool) {
+	block* next;
+	
+	if(pool == NULL) return;
+	
+	while(pool->blocks != NULL) {
+		next = pool->blocks->next;
+		free(pool->blocks);
+		pool->blocks = next;
+	}
+	
+	free(pool->index);
+	free(pool->list);
+	free(pool);
+}
+
+/*
+	This function returns the ID of a string, storing it in the pool if it is new
+*/
+int string_pool_intern(string_pool* pool, char* text, size_t length) {
+	int slot;
+	unsigned long hash = utils_hash_buffer(text, length);
+	pooled_string* string;
+	
+	slot = find_slot(pool, text, length, hash);
+	if(pool->index[slot] != INVALID) {
+		return pool->index[slot];
+	}
+	
+	/* Double the list when it is full */
+	if(pool->current_size == pool->total_size) {
+		pool->total_size *= 2;
+		pool->list = (pooled_string*)realloc(pool->list, pool->total_size * sizeof(pooled_string));
+		
+		if(pool->list == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	string = &pool->list[pool->current_size];
+	string->text = allocate(pool, length + 1);
+	memcpy(string->text, text, length);
+	string->text[length] = '\0';
+	string->length = length;
+	string->hash = hash;
+	
+	pool->index[slot] = pool->current_size++;
+	
+	/* Keep the index at most half full so probe sequences stay short */
+	if(pool->current_size * 2 > pool->index_size) {
+		grow_index(pool);
+	}
+	
+	return pool->current_size - 1;
+}
+
+/*
+	This function returns the ID of a string, or INVALID if it is not in the pool
+*/
+int string_pool_find(string_pool* pool, char* text, size_t length) {
+	return pool->index[find_slot(pool, text, length, utils_hash_buffer(text, length))];
+}
+
+/*
+	This function returns the text of an ID
+*/
+char* string_pool_get(string_pool* pool, int id) {
+	return pool->list[id].text;
+}
+
+/*
+	This function returns the amount of strings in the pool
+*/
+int string_pool_get_length(string_pool* pool) {
+	return pool->current_size;
+}
+
+/*
+This function probes the index linearly from the string's hash and returns the slot
+holding the string, or the first empty slot if the string is not in the pool
+*/
+static int find_slot(string_pool* pool, char* text, size_t length, unsigned long hash) {
+	int mask = pool->index_size - 1;
+	int slot = (int)(hash & mask);
+	pooled_string* string;
+	
+	while(pool->index[slot] != INVALID) {
+		string = &pool->list[pool->index[slot]];
+		
+		if(string->hash == hash && string->length == length && !memcmp(text, string->text, length)) {
+			return slot;
+		}
+		slot = (slot + 1) & mask;
+	}
+	
+	return slot;
+}
+
+/*
+This function doubles the size of the index and reinserts every string
+*/
+static void grow_index(string_pool* pool) {
+	int i;
+	pooled_string* string;
+	
+	free(pool->index);
+	pool->index_size *= 2;
+	pool->index = (int*)malloc(sizeof(int) * pool->index_size);
+	
+	if(pool->index == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	for(i=0; i < pool->index_size; i++) {
+		pool->index[i] = INVALID;
+	}
+	
+	for(i=0; i < pool->current_size; i++) {
+		string = &pool->list[i];
+		pool->index[find_slot(pool, string->text, string->length, string->hash)] = i;
+	}
+}
+
+/*
+This function bumps an amount of chars out of the current block, starting a new block
+when it has no room left. A string longer than a block gets a block of its own
+*/
+static char* allocate(string_pool* pool, size_t size) {
+	block* current = pool->blocks;
+	size_t block_size = STRING_POOL_BLOCK_SIZE;
+	
+	if(current == NULL || current->size - current->used < size) {
+		if(size > block_size) {
+			block_size = size;
+		}
+		
+		current = (block*)malloc(sizeof(block) + block_size);
+		
+		if(current == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+		
+		current->next = pool->blocks;
+		current->used = 0;
+		current->size = block_size;
+		pool->blocks = current;
+	}
+	
+	current->used += size;
+	return (char*)(current + 1) + current->used - size;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <stddef.h>
+
+#define STRING_POOL_BLOCK_SIZE 4096 /* Amount of chars in each block of the pool's arena */
+
+/* Represents a pool of interned strings, each stored once and identified by a number */
+typedef struct StringPool string_pool;
+
+/*
+* This function allocates a new empty string pool
+*/
+string_pool* string_pool_new();
+
+/*
+* This function frees a string pool and every string interned in it
+*/
+void string_pool_free(string_pool*);
+
+/*
+* This function recieves a string and its length and returns its ID in the pool,
+* storing it first if it is not in the pool yet. IDs are given in order from 0
+*/
+int string_pool_intern(string_pool*, char*, size_t);
+
+/*
+* This function recieves a string and its length and returns its ID in the pool,
+* or -1 if it was never interned
+*/
+int string_pool_find(string_pool*, char*, size_t);
+
+/*
+* This function recieves an ID and returns the null terminated string it stands for
+*/
+char* string_pool_get(string_pool*, int);
+
+/*
+* This function returns the amount of strings in the pool
+*/
+int string_pool_get_length(string_pool*);
+
+#endif
\ No newline at end of file
@@ -1,307 +1,416 @@
-#include "symbol_table.h"
-#include "utils.h"
-#include "constants.h"
-#include "error.h"
-#include <stdlib.h>
-
-
-/* Represents a symbol in the assembler */
-typedef struct Symbol {
-	char* name; /* Symbol name */
-	int type; /* Symbol type */
-	int address; /* Symbol address */
-} symbol;
-
-/* Represents a symbol table in the assembler */
-typedef struct SymbolTable {
-	struct Symbol** list; /* Pointer to symbol list */
-	int current_size; /* Amount of symbols appended so far */
-	int total_size; /* Total size allocated for symbol table */
-} symbol_table;
-
-
-
-/* This functions prints / frees / appends symbol to the specified symbol table */
-static void print_table(symbol_table*, int);
-static void free_table(symbol_table*);
-static void append_to(symbol_table*, symbol*);
-
-
-
-
-/* Global variables to symbol tables */
-symbol_table* data_table;
-symbol_table* instructions_table;
-symbol_table* extern_table;
-
-
-
-
-/* 
-	Initialize new symbol table
-*/
-void symbol_table_init() {
-	/* Allocate memory for all tables */
-	data_table = (symbol_table*)malloc(sizeof(symbol_table));
-	instructions_table = (symbol_table*)malloc(sizeof(symbol_table));
-	extern_table = (symbol_table*)malloc(sizeof(symbol_table));
-	
-	/* Initialize data table */
-	data_table->list = (symbol**)malloc(sizeof(symbol*));
-	data_table->current_size = 0;
-	data_table->total_size = 1;
-	
-	/* Initialize instructions table */
-	instructions_table->list = (symbol**)malloc(sizeof(symbol*));
-	instructions_table->current_size = 0;
-	instructions_table->total_size = 1;
-	
-	/* Initialize external table */
-	extern_table->list = (symbol**)malloc(sizeof(symbol*));
-	extern_table->current_size = 0;
-	extern_table->total_size = 1;
-}
-
-/*
-	Free all symbol tables
-*/
-void symbol_table_free() {
-	if(data_table != NULL) {
-		free_table(data_table);		
-	}
-	
-	if(instructions_table != NULL) {
-		free_table(instructions_table);
-	}
-	
-	if(extern_table != NULL) {
-		free_table(extern_table);
-	}
-}
-
-
-/*
-	This function initializes a new symbol and appends it to the appropriate table 
-*/
-void symbol_table_append(char* symbol_name, int symbol_type, int symbol_address) {
-	int length;
-	
-	symbol* sym = (symbol*)malloc(sizeof(symbol)); /* Allocate memory for symbol */
-	sym->name = utils_duplicate_string(symbol_name); /* Initialize symbol's name */
-	
-	
-	/* Get index of last non-null character to check if ':' */
-	length = strlen(sym->name) - 1;
-	
-	if(sym->name[length] == ':')
-		sym->name[length] = '\0';
-	
-	/* Assign symbol type and address */
-	sym->type = symbol_type;
-	sym->address = symbol_address;
-
-	/* According to symbol type append to appropriate table */
-	if(symbol_type == DC_TYPE) append_to(data_table, sym);
-	if(symbol_type == IC_TYPE) append_to(instructions_table, sym);
-	if(symbol_type == EXTERN_TYPE) append_to(extern_table, sym);
-}
-
-/*
-	This function prints the symbol table for debug purposes
-*/
-void symbol_table_print() {	
-	if(instructions_table != NULL) {
-		print_table(instructions_table, IC_TYPE);
-	}
-	
-	if(data_table != NULL) {
-		print_table(data_table, DC_TYPE);
-	}
-	
-	if(extern_table != NULL) {
-		print_table(extern_table, EXTERN_TYPE);
-	}
-}
-
-
-/*
-This function searches for a symbol in all three tables according to name, returns the index
-of the symbol in its table if found, and -1 if not.
-*/
-int symbol_table_is_symbol_in(char* name) {
-	int i;
-	
-	for(i=0; i < instructions_table->current_size; i++) {
-		if(!strcmp(name, instructions_table->list[i]->name)) {
-			return i;
-		}
-	}
-	
-	for(i=0; i < data_table->current_size; i++) {
-		if(!strcmp(name, data_table->list[i]->name)) {
-			return i;
-		}
-	}
-	
-	for(i=0; i < extern_table->current_size; i++) {
-		if(!strcmp(name, extern_table->list[i]->name)) {
-			return i;
-		}
-	}
-	
-	return INVALID;
-}
-
-/* 
-This function searches for a symbol specifically in the extern table
-*/
-int symbol_table_is_extern(char* name) {
-	int i;
-	
-	for(i=0; i < extern_table->current_size; i++) {
-		if(!strcmp(name, extern_table->list[i]->name)) {
-			return TRUE;
-		}
-	}
-	return FALSE;
-}
-
-/*
-This function searches for a symbol and returns its address 
-*/
-unsigned int symbol_table_get_address(char* name) {
-	int i;
-	
-	for(i=0; i < instructions_table->current_size; i++) {
-		if(!strcmp(name, instructions_table->list[i]->name)){
-			return instructions_table->list[i]->address;
-		}
-	}
-	
-	for(i=0; i < data_table->current_size; i++){
-		if(!strcmp(name, data_table->list[i]->name)) {
-			return data_table->list[i]->address;
-		}
-	}
-	
-	return FALSE;
-}
-
-/*
-This function recieves a symbol name and index and changes its type to entry
-*/
-void symbol_table_change_to_entry(char* name, int index) {
-	
-	if(index == INVALID) {
-		return;
-	}
-	
-	/* If index is within table's range and the name fits change to entry*/
-	if(index < data_table->current_size && !strcmp(name, data_table->list[index]->name))
-		data_table->list[index]->type = ENTRY_TYPE;
-	if (index < instructions_table->current_size && !strcmp(name, instructions_table->list[index]->name))
-		instructions_table->list[index]->type = ENTRY_TYPE;
-}
-
-/*
-This function adds MEMORY OFFSET(100) to all instruction symbols and adds
-MEMORY OFFSET + current IC to all data symbols
-*/
-void symbol_table_update_addresses(int ic) {
-	int i;
-	
-	for(i=0; i < instructions_table->current_size; i++) {
-		instructions_table->list[i]->address += MEMORY_OFFSET;
-	}
-	
-	for(i=0; i < data_table->current_size; i++) {
-		data_table->list[i]->address += MEMORY_OFFSET + ic;
-	}
-}
-
-/*
-This function takes in a file pointer and writes all symbols which are entry types
-with its corresponding addresses to the file 
-*/
-int symbol_table_make_ent_file(FILE* ent_file) {
-	int i;
-	int counter = 0;
-	
-	for(i=0; i < instructions_table -> current_size; i++) {
-		if(instructions_table->list[i]->type == ENTRY_TYPE) {
-			fprintf(ent_file, "%s\t%d\n", instructions_table->list[i]->name, instructions_table->list[i]->address);
-			counter++;
-		}
-	}
-	
-	for(i=0; i < data_table -> current_size; i++) {
-		if(data_table->list[i]->type == ENTRY_TYPE) {
-			fprintf(ent_file, "%s\t%d\n", data_table->list[i]->name, data_table->list[i]->address);
-			counter++;
-		}
-	}
-	
-	return counter;
-}
-
-/*
-This function returns the length of the extern symbol table
-*/
-int symbol_table_get_extern_length() {
-	return (extern_table->current_size);
-}
-
-/*
-This function recieves a table and a symbol and appends it to the table 
-*/
-static void append_to(symbol_table* table, symbol* sym) {
-	/* If table is full , reallocate */
-	if(table->current_size == table->total_size) {
-		table->list = (symbol**)realloc(table->list, (++(table->total_size)) * sizeof(symbol*));
-		
-		/* Raise error if memory failed to allocate */
-		if (table == NULL) {
-			raise_error(MEMORY_ERROR);
-			exit(FATAL_ERROR);
-		}
-	}
-	
-	/* Append to end of table and increment current_size */
-	table->list[table->current_size++] = sym;
-}
-
-
-static void print_table(symbol_table* table, int type_id) {
-	char* name;
-	int address;
-	int i;
-	char* types[] = {"Instructions", "Data", "External", "Entry"};
-
-	
-	
-	for(i=0; i < table->current_size; i++) {
-		name = utils_duplicate_string(table->list[i]->name);
-		address = table->list[i]->address;
-		printf("%s\t%s\t%d\n", name, types[type_id], address);
-		
-		free(name);
-	}
-}
-
-static void free_table(symbol_table* table) {
-	int i;
-
-	
-	if(table->list == NULL) return;
-	
-	for(i=0; i < table->current_size; i++) {
-		if(table->list[i] != NULL) {
-			free(table->list[i]->name);
-			free(table->list[i]);
-		}
-	}
-	
-	free(table->list);
-	free(table);
-}
-
+#include "symbol_table.h"
+#include "constants.h"
+#include "error.h"
+#include "string_pool.h"
+#include <string.h>
+#include <stdlib.h>
+
+
+/* Represents a symbol in the assembler */
+typedef struct Symbol {
+	char* name; /* Symbol name, interned in the table's pool */
+	int type; /* Symbol type */
+	int address; /* Symbol address */
+	int entry; /* Flag if the symbol is declared as entry */
+} symbol;
+
+/* Represents a use of an extern symbol by an instruction operand */
+typedef struct ExternUse {
+	int handle; /* Handle of the extern symbol */
+	int address; /* Address of the operand word */
+} extern_use;
+
+/* Represents the symbol table of the assembler, a list in order of declaration and the pool of its names */
+typedef struct SymbolTable {
+	struct Symbol* list; /* List of symbols, a handle to a symbol is its index in the list */
+	int current_size; /* Amount of symbols appended so far */
+	int total_size; /* Total size allocated for the list */
+	
+	string_pool* names; /* Names of the symbols and of the labels used as operands, each interned once */
+	int* handles; /* Handle of the first symbol declared with each name by the name's ID, INVALID if none */
+	int handles_size; /* Amount of IDs the handles can hold */
+	
+	int externs; /* Amount of extern symbols */
+	
+	int entries; /* Amount of entry symbols */
+	
+	struct ExternUse* uses; /* Uses of extern symbols in order of their addresses */
+	int uses_length; /* Amount of uses */
+	int uses_size; /* Amount of uses the list can hold */
+} symbol_table;
+
+
+
+/* This functions prints the symbols of a type */
+static void print_type(assembler_ctx*, int);
+/* This function appends the entry symbols of a type to an output buffer */
+static void add_entries_of_type(assembler_ctx*, output_buffer*, int);
+/* This function interns a name and returns its ID, making room for its handle */
+static int intern_name(assembler_ctx*, char*, size_t);
+
+
+
+
+/* 
+	Initialize new symbol table
+*/
+void symbol_table_init(assembler_ctx* ctx) {
+	ctx->symbols = (symbol_table*)malloc(sizeof(symbol_table));
+	
+	if(ctx->symbols == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	ctx->symbols->list = (symbol*)malloc(sizeof(symbol) * TABLE_BASE_SIZE);
+	ctx->symbols->current_size = 0;
+	ctx->symbols->total_size = TABLE_BASE_SIZE;
+	
+	ctx->symbols->names = string_pool_new();
+	ctx->symbols->handles = (int*)malloc(sizeof(int) * TABLE_BASE_SIZE);
+	ctx->symbols->handles_size = TABLE_BASE_SIZE;
+	
+	ctx->symbols->externs = 0;
+	
+	ctx->symbols->entries = 0;
+	
+	ctx->symbols->uses = (extern_use*)malloc(sizeof(extern_use) * TABLE_BASE_SIZE);
+	ctx->symbols->uses_length = 0;
+	ctx->symbols->uses_size = TABLE_BASE_SIZE;
+	
+	if(ctx->symbols->list == NULL || ctx->symbols->handles == NULL || ctx->symbols->uses == NULL) {
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+}
+
+/*
+	Free the symbol table
+*/
+void symbol_table_free(assembler_ctx* ctx) {
+	if(ctx->symbols == NULL) return;
+	
+	/* All the names are released with their pool */
+	string_pool_free(ctx->symbols->names);
+	free(ctx->symbols->handles);
+	free(ctx->symbols->uses);
+	free(ctx->symbols->list);
+	free(ctx->symbols);
+	ctx->symbols = NULL;
+}
+
+
+/*
+	This function initializes a new symbol and appends it to the table 
+*/
+void symbol_table_append(assembler_ctx* ctx, char* symbol_name, int symbol_type, int symbol_address) {
+	int id;
+	size_t length = strlen(symbol_name);
+	symbol* sym;
+	
+	/* If the list is full, double it */
+	if(ctx->symbols->current_size == ctx->symbols->total_size) {
+		ctx->symbols->total_size *= 2;
+		ctx->symbols->list = (symbol*)realloc(ctx->symbols->list, ctx->symbols->total_size * sizeof(symbol));
+		
+		/* Raise error if memory failed to allocate */
+		if (ctx->symbols->list == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	/* A label declaration is interned without its ':' */
+	if(length > 0 && symbol_name[length - 1] == ':')
+		length--;
+	
+	/* The first declaration of a name is the one found */
+	id = intern_name(ctx, symbol_name, length);
+	if(ctx->symbols->handles[id] == INVALID) {
+		ctx->symbols->handles[id] = ctx->symbols->current_size;
+	}
+	
+	/* Assign symbol name, type and address */
+	sym = &ctx->symbols->list[ctx->symbols->current_size];
+	sym->name = string_pool_get(ctx->symbols->names, id);
+	sym->type = symbol_type;
+	sym->address = symbol_address;
+	sym->entry = FALSE;
+	
+	if(symbol_type == EXTERN_TYPE) ctx->symbols->externs++;
+	
+	ctx->symbols->current_size++;
+}
+
+/*
+	This function prints the symbol table for debug purposes
+*/
+void symbol_table_print(assembler_ctx* ctx) {	
+	if(ctx->symbols == NULL) return;
+	
+	print_type(ctx, IC_TYPE);
+	print_type(ctx, DC_TYPE);
+	print_type(ctx, EXTERN_TYPE);
+}
+
+
+/*
+This function searches for a symbol by name, returns a handle to the symbol if found, and -1 if not.
+*/
+int symbol_table_is_symbol_in(assembler_ctx* ctx, char* name) {
+	return symbol_table_find(ctx, name, strlen(name));
+}
+
+/*
+This function searches for a symbol by a name of a given length, the name does not have to be null terminated
+*/
+int symbol_table_find(assembler_ctx* ctx, char* name, size_t length) {
+	int id = string_pool_find(ctx->symbols->names, name, length);
+	
+	return (id == INVALID) ? INVALID : ctx->symbols->handles[id];
+}
+
+/*
+This function interns the name of a label used as an operand and returns its ID, so the label
+can be resolved once all the symbols are declared without looking at its name again
+*/
+int symbol_table_reference(assembler_ctx* ctx, char* name, size_t length) {
+	return intern_name(ctx, name, length);
+}
+
+/*
+This function returns the handle of the symbol declared with a name ID, or -1 if there is none
+*/
+int symbol_table_get_handle(assembler_ctx* ctx, int id) {
+	return ctx->symbols->handles[id];
+}
+
+/* 
+This function searches for a symbol and checks if it is extern
+*/
+int symbol_table_is_extern(assembler_ctx* ctx, char* name) {
+	int handle = symbol_table_is_symbol_in(ctx, name);
+	
+	return (handle != INVALID && ctx->symbols->list[handle].type == EXTERN_TYPE) ? TRUE : FALSE;
+}
+
+/*
+This function searches for a symbol and returns its address, or 0 if it is extern or not found
+*/
+unsigned int symbol_table_get_address(assembler_ctx* ctx, char* name) {
+	return symbol_table_get_handle_address(ctx, symbol_table_is_symbol_in(ctx, name));
+}
+
+/*
+This function returns the type of the symbol of a handle
+*/
+int symbol_table_get_handle_type(assembler_ctx* ctx, int handle) {
+	return ctx->symbols->list[handle].type;
+}
+
+/*
+This function returns the address of the symbol of a handle, or 0 if it is extern or not a symbol
+*/
+unsigned int symbol_table_get_handle_address(assembler_ctx* ctx, int handle) {
+	if(handle == INVALID || ctx->symbols->list[handle].type == EXTERN_TYPE) {
+		return FALSE;
+	}
+	return ctx->symbols->list[handle].address;
+}
+
+/*
+This function recieves a symbol handle and marks it as entry
+*/
+void symbol_table_change_to_entry(assembler_ctx* ctx, int handle) {
+	
+	if(handle == INVALID) {
+		return;
+	}
+	
+	/* Extern symbols cannot be entries, and a symbol declared entry twice is kept once */
+	if(ctx->symbols->list[handle].type == EXTERN_TYPE || ctx->symbols->list[handle].entry) {
+		return;
+	}
+	
+	ctx->symbols->list[handle].entry = TRUE;
+	ctx->symbols->entries++;
+}
+
+/*
+This function records a use of an extern symbol by the operand word at an address
+*/
+void symbol_table_add_extern_use(assembler_ctx* ctx, int handle, int address) {
+	/* If the uses are full, double them */
+	if(ctx->symbols->uses_length == ctx->symbols->uses_size) {
+		ctx->symbols->uses_size *= 2;
+		ctx->symbols->uses = (extern_use*)realloc(ctx->symbols->uses, ctx->symbols->uses_size * sizeof(extern_use));
+		
+		if(ctx->symbols->uses == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	ctx->symbols->uses[ctx->symbols->uses_length].handle = handle;
+	ctx->symbols->uses[ctx->symbols->uses_length].address = address;
+	ctx->symbols->uses_length++;
+}
+
+/*
+This function adds MEMORY OFFSET(100) to all instruction symbols and adds
+MEMORY OFFSET + current IC to all data symbols
+*/
+void symbol_table_update_addresses(assembler_ctx* ctx, int ic) {
+	int i;
+	
+	for(i=0; i < ctx->symbols->current_size; i++) {
+		if(ctx->symbols->list[i].type == IC_TYPE) {
+			ctx->symbols->list[i].address += MEMORY_OFFSET;
+		}
+		
+		if(ctx->symbols->list[i].type == DC_TYPE) {
+			ctx->symbols->list[i].address += MEMORY_OFFSET + ic;
+		}
+	}
+}
+
+/*
+This function appends the symbols of another table in their order, before their addresses
+are updated. Stops and returns FALSE at the first name that is already declared
+*/
+int symbol_table_merge(assembler_ctx* ctx, assembler_ctx* source, int ic, int dc) {
+	int i;
+	symbol* sym;
+	
+	for(i=0; i < source->symbols->current_size; i++) {
+		sym = &source->symbols->list[i];
+		
+		if(symbol_table_find(ctx, sym->name, strlen(sym->name)) != INVALID) {
+			return FALSE;
+		}
+		
+		if(sym->type == IC_TYPE) {
+			symbol_table_append(ctx, sym->name, IC_TYPE, sym->address + ic);
+		} else if(sym->type == DC_TYPE) {
+			symbol_table_append(ctx, sym->name, DC_TYPE, sym->address + dc);
+		} else {
+			symbol_table_append(ctx, sym->name, sym->type, sym->address);
+		}
+	}
+	
+	return TRUE;
+}
+
+/*
+This function interns a name of another table, so labels it references can be resolved in this one
+*/
+int symbol_table_reference_from(assembler_ctx* ctx, assembler_ctx* source, int id) {
+	char* name = string_pool_get(source->symbols->names, id);
+	
+	return intern_name(ctx, name, strlen(name));
+}
+
+/*
+This function takes in an output buffer and appends all symbols which are entry types
+with its corresponding addresses to the buffer, instruction symbols first
+*/
+int symbol_table_make_ent_file(assembler_ctx* ctx, output_buffer* ent_file) {
+	add_entries_of_type(ctx, ent_file, IC_TYPE);
+	add_entries_of_type(ctx, ent_file, DC_TYPE);
+	
+	return ctx->symbols->entries;
+}
+
+/*
+This function takes in an output buffer and appends every use of an extern symbol
+with the address of its operand word to the buffer
+*/
+int symbol_table_make_ext_file(assembler_ctx* ctx, output_buffer* ext_file) {
+	int i;
+	
+	for(i=0; i < ctx->symbols->uses_length; i++) {
+		writer_add_ext_to_buffer(ext_file, ctx->symbols->list[ctx->symbols->uses[i].handle].name, ctx->symbols->uses[i].address);
+	}
+	
+	return ctx->symbols->uses_length;
+}
+
+/*
+This function returns the amount of entry symbols
+*/
+int symbol_table_get_entry_length(assembler_ctx* ctx) {
+	return ctx->symbols->entries;
+}
+
+/*
+This function returns the amount of uses of extern symbols
+*/
+int symbol_table_get_extern_use_length(assembler_ctx* ctx) {
+	return ctx->symbols->uses_length;
+}
+
+/*
+This function returns the amount of extern symbols
+*/
+int symbol_table_get_extern_length(assembler_ctx* ctx) {
+	return (ctx->symbols->externs);
+}
+
+/*
+This function interns a name in the pool, a new name has no symbol yet. The handles double
+with the pool so every ID has one
+*/
+static int intern_name(assembler_ctx* ctx, char* name, size_t length) {
+	int names = string_pool_get_length(ctx->symbols->names);
+	int id = string_pool_intern(ctx->symbols->names, name, length);
+	
+	/* IDs are given in order, so a new name always gets the next one */
+	if(id < names) {
+		return id;
+	}
+	
+	if(id == ctx->symbols->handles_size) {
+		ctx->symbols->handles_size *= 2;
+		ctx->symbols->handles = (int*)realloc(ctx->symbols->handles, ctx->symbols->handles_size * sizeof(int));
+		
+		if(ctx->symbols->handles == NULL) {
+			raise_error(MEMORY_ERROR);
+			exit(FATAL_ERROR);
+		}
+	}
+	
+	ctx->symbols->handles[id] = INVALID;
+	return id;
+}
+
+static void add_entries_of_type(assembler_ctx* ctx, output_buffer* ent_file, int type_id) {
+	int i;
+	symbol* sym;
+	
+	for(i=0; i < ctx->symbols->current_size; i++) {
+		sym = &ctx->symbols->list[i];
+		
+		if(sym->entry && sym->type == type_id) {
+			writer_buffer_add_string(ent_file, sym->name);
+			writer_buffer_add_char(ent_file, '\t');
+			writer_buffer_add_int(ent_file, sym->address);
+			writer_buffer_add_char(ent_file, '\n');
+		}
+	}
+}
+
+static void print_type(assembler_ctx* ctx, int type_id) {
+	int i;
+	char* types[] = {"Instructions", "Data", "External", "Entry"};
+	
+	for(i=0; i < ctx->symbols->current_size; i++) {
+		if(ctx->symbols->list[i].type == type_id) {
+			writer_buffer_add_string(ctx->messages, ctx->symbols->list[i].name);
+			writer_buffer_add_char(ctx->messages, '\t');
+			writer_buffer_add_string(ctx->messages, types[type_id]);
+			writer_buffer_add_char(ctx->messages, '\t');
+			writer_buffer_add_int(ctx->messages, ctx->symbols->list[i].address);
+			writer_buffer_add_char(ctx->messages, '\n');
+		}
+	}
+}
\ No newline at end of file
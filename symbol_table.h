@@ -1,63 +1,129 @@
-#ifndef SYMBOL_TABLE_H
-#define SYMBOL_TABLE_H
-#include <stdio.h>
-
-/*
-* This function initializes symbol tables
-*/
-void symbol_table_init();
-
-/*
-* This function frees symbol tables
-*/
-void symbol_table_free();
-
-/*
-* This function initializes a new symbol and appends it to the appropriate table
-*/
-void symbol_table_append(char*, int, int);
-
-/*
-* This function prints the symbol table to stdout
-*/
-void symbol_table_print();
-
-/*
-* This function searches for a symbol in all tables by name, returns the index
-* of the symbol in its table if found, and -1 if not
-*/
-int symbol_table_is_symbol_in(char*);
-
-/*
-* This function searches for a symbol specifically in the extern table
-*/
-int symbol_table_is_extern(char*);
-
-/*
-* This function searches for a symbol by name and returns its address
-*/
-unsigned int symbol_table_get_address(char*);
-
-/*
-* This function recieves a symbol name and index and changes its type to entry
-*/
-void symbol_table_change_to_entry(char*, int);
-
-/*
-* This function adds memory offset(100) to all instruction symbols and adds
-* memory offset + current ic to all data symbols
-*/
-void symbol_table_update_addresses(int);
-
-/*
-* This function takes in a file pointer and writes all symbols which are entry
-* types with its corresponding addresses to the file
-*/
-int symbol_table_make_ent_file(FILE*);
-
-/*
-* This function returns the length of the extern symbol table
-*/
-int symbol_table_get_extern_length();
-
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+#include <stdio.h>
+#include <stddef.h>
+#include "writer.h"
+#include "context.h"
+
+/*
+* This function initializes the symbol table
+*/
+void symbol_table_init(assembler_ctx*);
+
+/*
+* This function frees the symbol table
+*/
+void symbol_table_free(assembler_ctx*);
+
+/*
+* This function initializes a new symbol and appends it to the table
+*/
+void symbol_table_append(assembler_ctx*, char*, int, int);
+
+/*
+* This function prints the symbol table to stdout
+*/
+void symbol_table_print(assembler_ctx*);
+
+/*
+* This function searches for a symbol by name, returns a handle to the symbol if
+* found, and -1 if not. A handle stays valid as long as the table does
+*/
+int symbol_table_is_symbol_in(assembler_ctx*, char*);
+
+/*
+* This function searches for a symbol by a name of a given length, which does not
+* have to be null terminated. Returns a handle to the symbol if found, and -1 if not
+*/
+int symbol_table_find(assembler_ctx*, char*, size_t);
+
+/*
+* This function recieves the name of a label used as an operand and its length, and
+* returns an ID that symbol_table_get_handle resolves once the symbols are declared
+*/
+int symbol_table_reference(assembler_ctx*, char*, size_t);
+
+/*
+* This function recieves a name ID and returns the handle of the symbol declared
+* with the name, or -1 if there is none
+*/
+int symbol_table_get_handle(assembler_ctx*, int);
+
+/*
+* This function searches for a symbol by name and checks if it is extern
+*/
+int symbol_table_is_extern(assembler_ctx*, char*);
+
+/*
+* This function searches for a symbol by name and returns its address
+*/
+unsigned int symbol_table_get_address(assembler_ctx*, char*);
+
+/*
+* This function recieves a symbol handle and returns its type
+*/
+int symbol_table_get_handle_type(assembler_ctx*, int);
+
+/*
+* This function recieves a symbol handle and returns its address
+*/
+unsigned int symbol_table_get_handle_address(assembler_ctx*, int);
+
+/*
+* This function recieves a symbol handle and marks it as entry
+*/
+void symbol_table_change_to_entry(assembler_ctx*, int);
+
+/*
+* This function adds memory offset(100) to all instruction symbols and adds
+* memory offset + current ic to all data symbols
+*/
+void symbol_table_update_addresses(assembler_ctx*, int);
+
+/*
+* This function appends the symbols of the table of another context, moving
+* instruction symbols by an amount of instruction words and data symbols by an
+* amount of data words. Returns FALSE if a name is already declared in the table
+*/
+int symbol_table_merge(assembler_ctx*, assembler_ctx*, int, int);
+
+/*
+* This function interns the name of a name ID of the table of another context
+* and returns its ID in the table
+*/
+int symbol_table_reference_from(assembler_ctx*, assembler_ctx*, int);
+
+/*
+* This function takes in an output buffer and appends all symbols which are
+* entry types with its corresponding addresses to the buffer
+*/
+int symbol_table_make_ent_file(assembler_ctx*, output_buffer*);
+
+/*
+* This function records a use of an extern symbol handle by the operand word at
+* an address
+*/
+void symbol_table_add_extern_use(assembler_ctx*, int, int);
+
+/*
+* This function takes in an output buffer and appends every use of an extern
+* symbol with the address of its operand word to the buffer
+*/
+int symbol_table_make_ext_file(assembler_ctx*, output_buffer*);
+
+/*
+* This function returns the amount of symbols declared as entry
+*/
+int symbol_table_get_entry_length(assembler_ctx*);
+
+/*
+* This function returns the amount of uses of extern symbols
+*/
+int symbol_table_get_extern_use_length(assembler_ctx*);
+
+/*
+* This function returns the amount of extern symbols
+*/
+int symbol_table_get_extern_length(assembler_ctx*);
+
 #endif
\ No newline at end of file
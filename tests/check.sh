@@ -0,0 +1,62 @@
+#!/bin/sh
+# Assembles the files of every test directory in one run and compares the messages of the
+# run with output.txt and every output file with the one kept next to its source.
+# The run takes the options in the options file of the directory, --emit-am if there is none.
+# Usage: sh tests/check.sh [assembler], from the root of the repository
+
+ASSEMBLER=${1:-./assembler}
+ROOT=$(pwd)
+WORK=${TMPDIR:-/tmp}/assembler-check.$$
+FAILED=0
+
+case $ASSEMBLER in
+	/*) ;;
+	*) ASSEMBLER=$ROOT/$ASSEMBLER ;;
+esac
+
+for dir in tests/*/; do
+	dir=${dir%/}
+	options="--emit-am"
+	[ -f $dir/options ] && options=$(cat $dir/options)
+
+	rm -rf $WORK && mkdir -p $WORK && cp $dir/*.as $WORK/
+
+	# Every source is assembled, but files named in the options such as a macro prelude
+	names=""
+	for source in $WORK/*.as; do
+		name=$(basename $source .as)
+		case " $options " in
+			*" $name "*) ;;
+			*) names="$names $name" ;;
+		esac
+	done
+
+	(cd $WORK && $ASSEMBLER $options $names > output.txt 2>&1)
+
+	for produced in $WORK/*; do
+		file=$(basename $produced)
+		case $file in
+			*.as|*.mlib) continue ;;
+		esac
+
+		if [ ! -f $dir/$file ]; then
+			echo "$dir/$file: not expected"
+			FAILED=1
+		elif ! tr -d '\r' < $dir/$file | cmp -s - $produced; then
+			echo "$dir/$file: differs"
+			FAILED=1
+		fi
+	done
+
+	for expected in $dir/*.am $dir/*.ob $dir/*.ent $dir/*.ext; do
+		[ -f $expected ] || continue
+		if [ ! -f $WORK/$(basename $expected) ]; then
+			echo "$expected: not produced"
+			FAILED=1
+		fi
+	done
+done
+
+rm -rf $WORK
+[ $FAILED = 0 ] && echo "All tests passed"
+exit $FAILED
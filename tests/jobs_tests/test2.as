@@ -0,0 +1,9 @@
+#ABC: .data 25
+1HE: .string "HELLO""HELLO"
+mov @r1, L1
+mov L1, L2
+stop R2
+L1: .data -
+L2: .data -40241,529,9,99,990 0
+clr A3
+mov @r1
\ No newline at end of file
@@ -0,0 +1,6 @@
+; Uses the macros of the prelude
+    save
+    add 5, @r1
+    reset
+    stop
+SAVED: .data 0
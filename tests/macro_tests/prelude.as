@@ -0,0 +1,9 @@
+; Macros shared by every file of the run
+mcro save
+    mov @r1, SAVED
+    mov @r2, SAVED
+endmcro
+mcro reset
+    clr @r1
+    clr @r2
+endmcro
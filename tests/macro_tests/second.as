@@ -0,0 +1,11 @@
+; A macro of the file is used next to the macros of the prelude
+mcro twice
+    inc @r3
+    inc @r3
+endmcro
+    reset
+    twice
+    save
+    prn @r3
+    stop
+SAVED: .data 0
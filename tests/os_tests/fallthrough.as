@@ -0,0 +1,13 @@
+; The program runs past its last line, so no macro is outlined
+mcro push
+    mov @r1, @r2
+    add 1, @r1
+    prn @r1
+    inc COUNT
+endmcro
+MAIN: clr @r2
+    push
+    push
+    push
+    jmp MAIN
+COUNT: .data 0
@@ -0,0 +1,15 @@
+; The last expansion holds the last instruction, so its macro is not outlined
+mcro finish
+    prn @r1
+    inc COUNT
+    dec @r2
+    clr @r3
+    stop
+endmcro
+    cmp @r1, COUNT
+    bne SKIP
+    finish
+SKIP: prn @r2
+    finish
+    finish
+COUNT: .data 0
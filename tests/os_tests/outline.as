@@ -0,0 +1,15 @@
+; A macro expanded 3 times is outlined into a subroutine after the last line
+mcro push
+    mov @r1, @r2
+    add 1, @r1
+    prn @r1
+    inc COUNT
+endmcro
+MAIN: clr @r2
+    push
+    push
+    cmp @r1, COUNT
+    bne MAIN
+    push
+    stop
+COUNT: .data 0
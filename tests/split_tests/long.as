@@ -0,0 +1,299 @@
+; Long enough to be split into 3 chunks of at least 64 lines, labels are used across the chunks
+.extern OUTSIDE
+.entry LOOP0
+.entry TABLE
+LOOP0: mov @r0, @r1
+    add 0, COUNT0
+    cmp LOOP0, @r3
+    bne LOOP11
+LOOP1: mov @r1, @r2
+    add 1, COUNT1
+    cmp LOOP37, @r4
+    bne LOOP12
+LOOP2: mov @r2, @r3
+    add 2, COUNT2
+    cmp LOOP4, @r5
+    bne LOOP13
+LOOP3: mov @r3, @r4
+    add 3, COUNT3
+    cmp LOOP41, @r6
+    bne LOOP14
+LOOP4: mov @r4, @r5
+    add 4, COUNT4
+    cmp LOOP8, @r7
+    bne LOOP15
+LOOP5: mov @r5, @r6
+    add 5, COUNT0
+    cmp LOOP45, @r0
+    bne LOOP16
+LOOP6: mov @r6, @r7
+    add 6, COUNT1
+    cmp LOOP12, @r1
+    bne LOOP17
+LOOP7: mov @r7, @r0
+    add 7, COUNT2
+    cmp LOOP49, @r2
+    bne LOOP18
+LOOP8: mov @r0, @r1
+    add 8, COUNT3
+    cmp LOOP16, @r3
+    bne LOOP19
+LOOP9: mov @r1, @r2
+    add 9, COUNT4
+    cmp LOOP53, @r4
+    jsr OUTSIDE
+    bne LOOP20
+LOOP10: mov @r2, @r3
+    add 10, COUNT0
+    cmp LOOP20, @r5
+    bne LOOP21
+LOOP11: mov @r3, @r4
+    add 11, COUNT1
+    cmp LOOP57, @r6
+    bne LOOP22
+LOOP12: mov @r4, @r5
+    add 12, COUNT2
+    cmp LOOP24, @r7
+    bne LOOP23
+LOOP13: mov @r5, @r6
+    add 13, COUNT3
+    cmp LOOP61, @r0
+    bne LOOP24
+LOOP14: mov @r6, @r7
+    add 14, COUNT4
+    cmp LOOP28, @r1
+    bne LOOP25
+LOOP15: mov @r7, @r0
+    add 15, COUNT0
+    cmp LOOP65, @r2
+    bne LOOP26
+LOOP16: mov @r0, @r1
+    add 16, COUNT1
+    cmp LOOP32, @r3
+    bne LOOP27
+LOOP17: mov @r1, @r2
+    add 17, COUNT2
+    cmp LOOP69, @r4
+    bne LOOP28
+LOOP18: mov @r2, @r3
+    add 18, COUNT3
+    cmp LOOP36, @r5
+    bne LOOP29
+LOOP19: mov @r3, @r4
+    add 19, COUNT4
+    cmp LOOP3, @r6
+    jsr OUTSIDE
+    bne LOOP30
+LOOP20: mov @r4, @r5
+    add 20, COUNT0
+    cmp LOOP40, @r7
+    bne LOOP31
+LOOP21: mov @r5, @r6
+    add 21, COUNT1
+    cmp LOOP7, @r0
+    bne LOOP32
+LOOP22: mov @r6, @r7
+    add 22, COUNT2
+    cmp LOOP44, @r1
+    bne LOOP33
+LOOP23: mov @r7, @r0
+    add 23, COUNT3
+    cmp LOOP11, @r2
+    bne LOOP34
+LOOP24: mov @r0, @r1
+    add 24, COUNT4
+    cmp LOOP48, @r3
+    bne LOOP35
+LOOP25: mov @r1, @r2
+    add 25, COUNT0
+    cmp LOOP15, @r4
+    bne LOOP36
+LOOP26: mov @r2, @r3
+    add 26, COUNT1
+    cmp LOOP52, @r5
+    bne LOOP37
+LOOP27: mov @r3, @r4
+    add 27, COUNT2
+    cmp LOOP19, @r6
+    bne LOOP38
+LOOP28: mov @r4, @r5
+    add 28, COUNT3
+    cmp LOOP56, @r7
+    bne LOOP39
+LOOP29: mov @r5, @r6
+    add 29, COUNT4
+    cmp LOOP23, @r0
+    jsr OUTSIDE
+    bne LOOP40
+LOOP30: mov @r6, @r7
+    add 30, COUNT0
+    cmp LOOP60, @r1
+    bne LOOP41
+LOOP31: mov @r7, @r0
+    add 31, COUNT1
+    cmp LOOP27, @r2
+    bne LOOP42
+LOOP32: mov @r0, @r1
+    add 32, COUNT2
+    cmp LOOP64, @r3
+    bne LOOP43
+LOOP33: mov @r1, @r2
+    add 33, COUNT3
+    cmp LOOP31, @r4
+    bne LOOP44
+LOOP34: mov @r2, @r3
+    add 34, COUNT4
+    cmp LOOP68, @r5
+    bne LOOP45
+LOOP35: mov @r3, @r4
+    add 35, COUNT0
+    cmp LOOP35, @r6
+    bne LOOP46
+LOOP36: mov @r4, @r5
+    add 36, COUNT1
+    cmp LOOP2, @r7
+    bne LOOP47
+LOOP37: mov @r5, @r6
+    add 37, COUNT2
+    cmp LOOP39, @r0
+    bne LOOP48
+LOOP38: mov @r6, @r7
+    add 38, COUNT3
+    cmp LOOP6, @r1
+    bne LOOP49
+LOOP39: mov @r7, @r0
+    add 39, COUNT4
+    cmp LOOP43, @r2
+    jsr OUTSIDE
+    bne LOOP50
+LOOP40: mov @r0, @r1
+    add 40, COUNT0
+    cmp LOOP10, @r3
+    bne LOOP51
+LOOP41: mov @r1, @r2
+    add 41, COUNT1
+    cmp LOOP47, @r4
+    bne LOOP52
+LOOP42: mov @r2, @r3
+    add 42, COUNT2
+    cmp LOOP14, @r5
+    bne LOOP53
+LOOP43: mov @r3, @r4
+    add 43, COUNT3
+    cmp LOOP51, @r6
+    bne LOOP54
+LOOP44: mov @r4, @r5
+    add 44, COUNT4
+    cmp LOOP18, @r7
+    bne LOOP55
+LOOP45: mov @r5, @r6
+    add 45, COUNT0
+    cmp LOOP55, @r0
+    bne LOOP56
+LOOP46: mov @r6, @r7
+    add 46, COUNT1
+    cmp LOOP22, @r1
+    bne LOOP57
+LOOP47: mov @r7, @r0
+    add 47, COUNT2
+    cmp LOOP59, @r2
+    bne LOOP58
+LOOP48: mov @r0, @r1
+    add 48, COUNT3
+    cmp LOOP26, @r3
+    bne LOOP59
+LOOP49: mov @r1, @r2
+    add 49, COUNT4
+    cmp LOOP63, @r4
+    jsr OUTSIDE
+    bne LOOP60
+LOOP50: mov @r2, @r3
+    add 50, COUNT0
+    cmp LOOP30, @r5
+    bne LOOP61
+LOOP51: mov @r3, @r4
+    add 51, COUNT1
+    cmp LOOP67, @r6
+    bne LOOP62
+LOOP52: mov @r4, @r5
+    add 52, COUNT2
+    cmp LOOP34, @r7
+    bne LOOP63
+LOOP53: mov @r5, @r6
+    add 53, COUNT3
+    cmp LOOP1, @r0
+    bne LOOP64
+LOOP54: mov @r6, @r7
+    add 54, COUNT4
+    cmp LOOP38, @r1
+    bne LOOP65
+LOOP55: mov @r7, @r0
+    add 55, COUNT0
+    cmp LOOP5, @r2
+    bne LOOP66
+LOOP56: mov @r0, @r1
+    add 56, COUNT1
+    cmp LOOP42, @r3
+    bne LOOP67
+LOOP57: mov @r1, @r2
+    add 57, COUNT2
+    cmp LOOP9, @r4
+    bne LOOP68
+LOOP58: mov @r2, @r3
+    add 58, COUNT3
+    cmp LOOP46, @r5
+    bne LOOP69
+LOOP59: mov @r3, @r4
+    add 59, COUNT4
+    cmp LOOP13, @r6
+    jsr OUTSIDE
+    bne LOOP0
+LOOP60: mov @r4, @r5
+    add 60, COUNT0
+    cmp LOOP50, @r7
+    bne LOOP1
+LOOP61: mov @r5, @r6
+    add 61, COUNT1
+    cmp LOOP17, @r0
+    bne LOOP2
+LOOP62: mov @r6, @r7
+    add 62, COUNT2
+    cmp LOOP54, @r1
+    bne LOOP3
+LOOP63: mov @r7, @r0
+    add 63, COUNT3
+    cmp LOOP21, @r2
+    bne LOOP4
+LOOP64: mov @r0, @r1
+    add 64, COUNT4
+    cmp LOOP58, @r3
+    bne LOOP5
+LOOP65: mov @r1, @r2
+    add 65, COUNT0
+    cmp LOOP25, @r4
+    bne LOOP6
+LOOP66: mov @r2, @r3
+    add 66, COUNT1
+    cmp LOOP62, @r5
+    bne LOOP7
+LOOP67: mov @r3, @r4
+    add 67, COUNT2
+    cmp LOOP29, @r6
+    bne LOOP8
+LOOP68: mov @r4, @r5
+    add 68, COUNT3
+    cmp LOOP66, @r7
+    bne LOOP9
+LOOP69: mov @r5, @r6
+    add 69, COUNT4
+    cmp LOOP33, @r0
+    jsr OUTSIDE
+    bne LOOP10
+    stop
+COUNT0: .data 0, -0
+COUNT1: .data 3, -1
+COUNT2: .data 6, -2
+COUNT3: .data 9, -3
+COUNT4: .data 12, -4
+TABLE: .string "split"
+.entry LOOP69
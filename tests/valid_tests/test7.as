@@ -0,0 +1,10 @@
+;repeated values and a label named x
+
+x:  .data 7, 0 * 4, -2
+    .space 3
+mov x, @r1
+prn x
+jmp x
+W:  .data 5 * 2,1
+.entry x
+stop
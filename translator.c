@@ -1,142 +1,250 @@
-#include "translator.h"
-#include "constants.h"
-#include "symbol_table.h"
-#include "writer.h"
-#include "error.h"
-#include "globals.h"
-#include <string.h>
-#include <stdlib.h>
-
-const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-/*
-* This function converts an address value to its binary representation by extracting
-* each bit of the address using a mask and stores the resulting binary string in
-* the 'binary_coding' array.
-*/
-static void convert_address_to_binary(char*, unsigned int);
-
-/*
- * This function converts a number to its binary representation by extracting each bit
- * of the number using a mask and stores the resulting binary string in the
- * 'binary_coding' array.
- */
-static void convert_number_to_binary(char*, int);
-
-/*
-Translates a word of binary coding into a base64 format and writes it to the output file.
- */
-void translator_translate_word(FILE* ob_file, char* coding) {
-    unsigned int value = 0;
-    int i;
-    
-    for(i=0; i < WORD_SIZE; i++) {
-        value <<= 1;
-        value |= (coding[i] - '0');
-    }
-    
-    fprintf(ob_file, "%c%c\n", base64[(value>>6) & 0x3F], base64[value & 0x3F]);
-}
-
-/*
-Encode an instruction operand into its binary representation.
-*/
-void translator_encode_operand(char* coding, char* token, int type, FILE* ext_file, int operand_index) {
-	if(type == LABEL) {
-		/* If operand is a label and extern */
-		if(symbol_table_is_extern(token)) {
-			strcpy(coding, "0000000000");
-			strcat(coding, "01");
-			
-			/* Add line to EXT file since we used and extern label in some instruction */
-			writer_add_ext_to_file(ext_file, token, ic + operand_index);
-		}else{
-			/* If is not extern encode symbol address */
-			convert_address_to_binary(coding, symbol_table_get_address(token));
-			strcat(coding, "10");
-		}
-	}
-	
-	if(type == ABSOLUTE) {
-		/* Convert absolute value to binary */
-		convert_number_to_binary(coding, (atoi(token)));
-		strcat(coding, "00");
-	}
-}
-
-
-/*
-Encodes a data operand into its binary representation.
-*/
-void translator_encode_data(char* coding, int num) {
-    int i;
-	int mask = 1 << 11;
-    
-	/* If number cannot be represented by 12 bits raise errors */
-    if (num < MIN_DATA_OPERAND || num > MAX_DATA_OPERAND) {
-        raise_error_in_line(OVERFLOW_DATA_OPERAND, line_num);
-    }
-    
-	/* Assign each bit to its corressponding place */
-    for(i=0; i < WORD_SIZE; i++) {
-		coding[i] = (mask & num)? '1':'0';
-		mask>>=1;
-	}
-	
-	/* End with null character */
-	coding[WORD_SIZE] = '\0';
-}
-
-/*
-This function encodes a char operand to its binary representation
-*/
-void translator_encode_char(char* coding, char character) {
-	int i;
-	int mask = 1 << 11;
-	
-	for(i=0; i < WORD_SIZE; i++) {
-		/* Check if the current bit is set and encode it as '1' or '0' */
-		coding[i] = (character & mask)? '1':'0';
-		/* Shift the mask to the right to check the next bit */
-		mask >>= 1;
-	}
-	/* Add null character */
-	coding[WORD_SIZE] = '\0';
-}
-
-/*
-This function converts an address value to its binary representation by extracting
-each bit of the address using a mask and stores the resulting binary string in
-the 'binary_coding' array.
- */
-static void convert_address_to_binary(char* binary_coding, unsigned int address) {
-	int i;
-	int mask = 1 << 9;
-	
-	for(i=0; i < WORD_SIZE - 2; i++) {
-		binary_coding[i] = (address & mask)? '1':'0';
-		mask >>= 1;
-	}
-	
-	binary_coding[WORD_SIZE] = '\0';
-}
-
-/*
- This function converts a number to its binary representation by extracting each bit
- of the number using a mask and stores the resulting binary string in the
- 'binary_coding' array.
-*/
-static void convert_number_to_binary(char* binary_coding, int number) {
-	int mask = 1 << 9;
-	int i;
-	
-	for(i=0; i < WORD_SIZE - 2; i++) {
-		/* Check if the current bit is set and encode it as '1' or '0' */
-		binary_coding[i] = (number & mask)? '1':'0'; 
-		/* Shift the mask to the right to check the next bit */
-		mask >>= 1;
-	}
-	
-	/* Add null character */
-	binary_coding[WORD_SIZE] = '\0';
-}
+#include "translator.h"
+#include "constants.h"
+#include "symbol_table.h"
+#include "error.h"
+#include <string.h>
+#include <stdlib.h>
+
+/* SIMD kernels are built for x86 compilers which support target attributes */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TRANSLATOR_SIMD
+#include <immintrin.h>
+#endif
+
+static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* The 2 base64 chars of every word, built on first use */
+static char base64_pairs[(WORD_MASK + 1) * 2];
+
+/* This function chooses the fastest kernel the CPU supports */
+static void choose_kernel();
+/* This function writes the records of words one at a time from the table of pairs */
+static void scalar_kernel(char*, const machine_word*, int);
+
+#ifdef TRANSLATOR_SIMD
+/* This function writes the records of 8 words at a time */
+static void ssse3_kernel(char*, const machine_word*, int) __attribute__((target("ssse3")));
+/* This function writes the records of 16 words at a time */
+static void avx2_kernel(char*, const machine_word*, int) __attribute__((target("avx2")));
+#endif
+
+/* Kernel used to translate words, chosen by translator_init or on first use */
+static void (*kernel)(char*, const machine_word*, int) = NULL;
+
+/*
+* This function packs an operand value into the bits above the A,R,E field of a word,
+* keeping only the bits an operand has room for
+*/
+static machine_word pack_operand(int, int);
+
+/*
+Chooses the kernel before the first translation instead of on it
+*/
+void translator_init() {
+	if(kernel == NULL) choose_kernel();
+}
+
+/*
+Translates a list of encoded words into base64 records, 2 chars and a new line for each word,
+written to a buffer of BASE64_RECORD_SIZE chars per word. Returns the amount of chars written.
+ */
+size_t translator_translate_words(char* out, machine_word* words, int count) {
+	if(kernel == NULL) choose_kernel();
+	
+	kernel(out, words, count);
+	return (size_t)count * BASE64_RECORD_SIZE;
+}
+
+/*
+Encodes the first word of an instruction from its command and the addressing types of its operands.
+*/
+machine_word translator_encode_command(int command_type, int source_type, int destination_type) {
+	return (machine_word)((source_type << SOURCE_TYPE_SHIFT) | (command_type << OPCODE_SHIFT) |
+		(destination_type << DESTINATION_TYPE_SHIFT) | ARE_ABSOLUTE);
+}
+
+/*
+Encodes a source and a destination register in a word, INVALID leaves a position empty.
+*/
+machine_word translator_encode_registers(int source, int destination) {
+	machine_word word = ARE_ABSOLUTE;
+	
+	if(source != INVALID) word |= source << SOURCE_REGISTER_SHIFT;
+	if(destination != INVALID) word |= destination << DESTINATION_REGISTER_SHIFT;
+	
+	return word;
+}
+
+/*
+Encode an instruction operand into its binary representation. The value of a label is the handle of its symbol,
+the address of the operand word is recorded for the EXT file if the symbol is extern.
+*/
+machine_word translator_encode_operand(assembler_ctx* ctx, int type, int value, int address) {
+	if(type == LABEL) {
+		/* If operand is a label and extern */
+		if(symbol_table_get_handle_type(ctx, value) == EXTERN_TYPE) {
+			/* Record the use for the EXT file since we used an extern label in some instruction */
+			symbol_table_add_extern_use(ctx, value, address);
+			return ARE_EXTERNAL;
+		}
+		
+		/* If is not extern encode symbol address */
+		return pack_operand((int)symbol_table_get_handle_address(ctx, value), ARE_RELOCATABLE);
+	}
+	
+	/* Absolute value */
+	return pack_operand(value, ARE_ABSOLUTE);
+}
+
+
+/*
+Encodes a data operand into its binary representation.
+*/
+machine_word translator_encode_data(assembler_ctx* ctx, int num) {
+	/* If number cannot be represented by 12 bits raise errors */
+    if (num < MIN_DATA_OPERAND || num > MAX_DATA_OPERAND) {
+        raise_error_in_line(ctx, OVERFLOW_DATA_OPERAND, ctx->line_num);
+    }
+    
+	/* Negative numbers keep their two's complement bits */
+	return (machine_word)(num & WORD_MASK);
+}
+
+/*
+This function encodes a char operand to its binary representation
+*/
+machine_word translator_encode_char(char character) {
+	return (machine_word)(character & WORD_MASK);
+}
+
+/*
+This function packs the lower bits of an operand value above the A,R,E field, a negative
+value keeps its two's complement bits. The value is shifted unsigned, shifting a negative int is undefined
+*/
+static machine_word pack_operand(int value, int are) {
+	return (machine_word)((((unsigned long)value << ARE_SIZE) | (unsigned long)are) & WORD_MASK);
+}
+
+/*
+This function builds the table of pairs and chooses the kernel by the features of the CPU,
+the scalar one is used on other architectures
+*/
+static void choose_kernel() {
+	int word;
+	
+	for(word=0; word <= WORD_MASK; word++) {
+		base64_pairs[word * 2] = base64[(word >> 6) & 0x3F];
+		base64_pairs[word * 2 + 1] = base64[word & 0x3F];
+	}
+	
+	kernel = scalar_kernel;
+	
+#ifdef TRANSLATOR_SIMD
+	/* The kernels load words as 16 bit lanes */
+	if(sizeof(machine_word) != 2) return;
+	
+	__builtin_cpu_init();
+	
+	if(__builtin_cpu_supports("avx2")) {
+		kernel = avx2_kernel;
+	} else if(__builtin_cpu_supports("ssse3")) {
+		kernel = ssse3_kernel;
+	}
+#endif
+}
+
+/*
+This function writes the record of each word by looking up its pair of chars
+*/
+static void scalar_kernel(char* out, const machine_word* words, int count) {
+	int i;
+	const char* pair;
+	
+	for(i=0; i < count; i++) {
+		pair = base64_pairs + (words[i] & WORD_MASK) * 2;
+		out[0] = pair[0];
+		out[1] = pair[1];
+		out[2] = '\n';
+		out += BASE64_RECORD_SIZE;
+	}
+}
+
+#ifdef TRANSLATOR_SIMD
+/*
+This function splits 8 words into their high and low 6 bits, turns each into its base64 char
+by the range it falls in, and shuffles the chars into records with new lines between them.
+The records of 8 words take 24 chars, written as 16 and 8.
+*/
+static void ssse3_kernel(char* out, const machine_word* words, int count) {
+	int i;
+	__m128i values, sextets, offsets, chars;
+	const __m128i first = _mm_setr_epi8(0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, 8, 9, -1, 10);
+	const __m128i second = _mm_setr_epi8(11, -1, 12, 13, -1, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i first_lines = _mm_setr_epi8(0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0);
+	const __m128i second_lines = _mm_setr_epi8(0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, 0, 0, 0, 0, 0, 0);
+	
+	for(i=0; i + 8 <= count; i += 8) {
+		values = _mm_loadu_si128((const __m128i*)(words + i));
+		
+		/* The high 6 bits go to the first byte of each word and the low 6 bits to the second */
+		sextets = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(values, 6), _mm_set1_epi16(0x3F)),
+			_mm_and_si128(_mm_slli_epi16(values, 8), _mm_set1_epi16(0x3F00)));
+		
+		/* A-Z, then a-z from 26, 0-9 from 52, and + and / for 62 and 63 */
+		offsets = _mm_set1_epi8('A');
+		offsets = _mm_add_epi8(offsets, _mm_and_si128(_mm_cmpgt_epi8(sextets, _mm_set1_epi8(25)), _mm_set1_epi8('a' - 26 - 'A')));
+		offsets = _mm_add_epi8(offsets, _mm_and_si128(_mm_cmpgt_epi8(sextets, _mm_set1_epi8(51)), _mm_set1_epi8(('0' - 52) - ('a' - 26))));
+		offsets = _mm_add_epi8(offsets, _mm_and_si128(_mm_cmpeq_epi8(sextets, _mm_set1_epi8(62)), _mm_set1_epi8('+' - 62 - ('0' - 52))));
+		offsets = _mm_add_epi8(offsets, _mm_and_si128(_mm_cmpeq_epi8(sextets, _mm_set1_epi8(63)), _mm_set1_epi8('/' - 63 - ('0' - 52))));
+		chars = _mm_add_epi8(sextets, offsets);
+		
+		_mm_storeu_si128((__m128i*)out, _mm_or_si128(_mm_shuffle_epi8(chars, first), first_lines));
+		_mm_storel_epi64((__m128i*)(out + 16), _mm_or_si128(_mm_shuffle_epi8(chars, second), second_lines));
+		out += 8 * BASE64_RECORD_SIZE;
+	}
+	
+	scalar_kernel(out, words + i, count - i);
+}
+
+/*
+This function does the same as the SSSE3 kernel for 16 words at a time, the shuffles work
+within each half so every half holds the records of 8 words
+*/
+static void avx2_kernel(char* out, const machine_word* words, int count) {
+	int i;
+	__m256i values, sextets, offsets, chars, firsts, seconds;
+	const __m256i first = _mm256_setr_epi8(0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, 8, 9, -1, 10,
+		0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, 8, 9, -1, 10);
+	const __m256i second = _mm256_setr_epi8(11, -1, 12, 13, -1, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		11, -1, 12, 13, -1, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m256i first_lines = _mm256_setr_epi8(0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0,
+		0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, '\n', 0);
+	const __m256i second_lines = _mm256_setr_epi8(0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, 0, 0, 0, 0, 0, 0,
+		0, '\n', 0, 0, '\n', 0, 0, '\n', 0, 0, 0, 0, 0, 0, 0, 0);
+	
+	for(i=0; i + 16 <= count; i += 16) {
+		values = _mm256_loadu_si256((const __m256i*)(words + i));
+		
+		sextets = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(values, 6), _mm256_set1_epi16(0x3F)),
+			_mm256_and_si256(_mm256_slli_epi16(values, 8), _mm256_set1_epi16(0x3F00)));
+		
+		offsets = _mm256_set1_epi8('A');
+		offsets = _mm256_add_epi8(offsets, _mm256_and_si256(_mm256_cmpgt_epi8(sextets, _mm256_set1_epi8(25)), _mm256_set1_epi8('a' - 26 - 'A')));
+		offsets = _mm256_add_epi8(offsets, _mm256_and_si256(_mm256_cmpgt_epi8(sextets, _mm256_set1_epi8(51)), _mm256_set1_epi8(('0' - 52) - ('a' - 26))));
+		offsets = _mm256_add_epi8(offsets, _mm256_and_si256(_mm256_cmpeq_epi8(sextets, _mm256_set1_epi8(62)), _mm256_set1_epi8('+' - 62 - ('0' - 52))));
+		offsets = _mm256_add_epi8(offsets, _mm256_and_si256(_mm256_cmpeq_epi8(sextets, _mm256_set1_epi8(63)), _mm256_set1_epi8('/' - 63 - ('0' - 52))));
+		chars = _mm256_add_epi8(sextets, offsets);
+		
+		firsts = _mm256_or_si256(_mm256_shuffle_epi8(chars, first), first_lines);
+		seconds = _mm256_or_si256(_mm256_shuffle_epi8(chars, second), second_lines);
+		
+		_mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(firsts));
+		_mm_storel_epi64((__m128i*)(out + 16), _mm256_castsi256_si128(seconds));
+		_mm_storeu_si128((__m128i*)(out + 24), _mm256_extracti128_si256(firsts, 1));
+		_mm_storel_epi64((__m128i*)(out + 40), _mm256_extracti128_si256(seconds, 1));
+		out += 16 * BASE64_RECORD_SIZE;
+	}
+	
+	scalar_kernel(out, words + i, count - i);
+}
+#endif
\ No newline at end of file
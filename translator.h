@@ -1,25 +1,65 @@
-#ifndef TRANSLATOR_H
-#define TRANSLATOR_H
-
-#include <stdio.h>
-
-/*
-* Translates a word of binary into base64 format and writes it to output file
-*/
-void translator_translate_word(FILE*, char*);
-
-/*
-* Encodes an instruction operand into its binary representation
-*/
-void translator_encode_operand(char*, char*, int, FILE*, int);
-
-/*
-* Encodes a data operand into its binary representation
-*/
-void translator_encode_data(char*, int);
-
-/*
-* Encodes a char operand into its binary representation
-*/
-void translator_encode_char(char*, char);
+#ifndef TRANSLATOR_H
+#define TRANSLATOR_H
+
+#include <stdio.h>
+#include "image.h"
+#include "context.h"
+
+/* Positions of the fields of an instruction's first word */
+#define SOURCE_TYPE_SHIFT 9
+#define OPCODE_SHIFT 5
+#define DESTINATION_TYPE_SHIFT 2
+
+/* Positions of the registers in a register operand word */
+#define SOURCE_REGISTER_SHIFT 7
+#define DESTINATION_REGISTER_SHIFT 2
+
+/* Values of the A,R,E field, the lowest ARE_SIZE bits of every instruction word */
+#define ARE_SIZE 2
+#define ARE_ABSOLUTE 0
+#define ARE_EXTERNAL 1
+#define ARE_RELOCATABLE 2
+
+#define BASE64_RECORD_SIZE 3 /* Chars written to the .ob file for each word */
+
+/*
+* Chooses the kernel of translator_translate_words ahead of time, so files can
+* be translated by several threads at once
+*/
+void translator_init();
+
+/*
+* Translates a list of encoded words into base64 records, 2 chars and a new line
+* for each word, written to a buffer of BASE64_RECORD_SIZE chars per word.
+* SIMD kernels are used when the CPU supports them. Returns the amount of chars written
+*/
+size_t translator_translate_words(char*, machine_word*, int);
+
+/*
+* Encodes the first word of an instruction from its command type and the addressing
+* types of its source and destination
+*/
+machine_word translator_encode_command(int, int, int);
+
+/*
+* Encodes a source and a destination register into a single word, INVALID leaves
+* a register's position empty
+*/
+machine_word translator_encode_registers(int, int);
+
+/*
+* Encodes an instruction operand of an addressing type and value into its binary representation,
+* given the address of its word
+*/
+machine_word translator_encode_operand(assembler_ctx*, int, int, int);
+
+/*
+* Encodes a data operand into its binary representation
+*/
+machine_word translator_encode_data(assembler_ctx*, int);
+
+/*
+* Encodes a char operand into its binary representation
+*/
+machine_word translator_encode_char(char);
 #endif
\ No newline at end of file
@@ -1,153 +1,166 @@
-#include "utils.h"
-#include "error.h"
-#include "constants.h"
-
-/* 
-This function takes an input string 'input' and appends the provided 'extension' to it.
-It allocates memory for the new string and returns the pointer to the new string.
-*/
-char* utils_format_file_name(char* input, const char* extension){
-	size_t inputLen = strlen(input);
-    size_t extensionLen = strlen(extension);
-
-    /* Allocate memory for the new string, including space for the extension and the null terminator */
-    char* result = (char*)malloc(inputLen + extensionLen + 1);
-	result[inputLen + extensionLen] = '\0'; /* Null-terminate the string */
-
-	if(result == NULL){
-		raise_error(MEMORY_ERROR);
-		exit(FATAL_ERROR);
-	}
-	
-	strcpy(result, input); /* Copy the input string to the new memory location */
-	strcat(result, extension); /* Concatenate the extension to the new string */
-	
-	return result;
-}
-
-/*
-This function duplicates a string to a new allocated block of memory
-*/
-char* utils_duplicate_string(char* source) {
-    size_t length = strlen(source);
-
-    /* Allocate memory for the new string, including space for the null terminator */
-    char* dest = (char*)malloc(length + 1);
-
-    if (dest != NULL) {
-        /* Copy the content of the 'source' string to the new memory location */
-        strcpy(dest, source);
-    }
-
-    return dest;
-}
-
-char** utils_tokenize(char* input_string, int* tokens_count, const char* delim){
-	char* token; /* Current token */
-	char* copy_string; /* Copy to input to avoid manipulating original */
-	char** tokens; /* Tokens array */
-	int count = 0; /* Number of tokens inputted so far */
-	
-	/* Allocate memory and handle errors */
-	tokens = (char**)malloc(sizeof(char*) * MAX_TOKENS);
-	
-	if(tokens == NULL){
-		raise_error(MEMORY_ERROR);
-		exit(FATAL_ERROR);
-	}
-	
-	/* Copy original string to copy and check for errors */
-	copy_string = utils_duplicate_string(input_string);
-	
-	if(copy_string == NULL){
-		raise_error(MEMORY_ERROR);
-		free(tokens);
-		exit(FATAL_ERROR);
-	}
-	
-	/* Start dividing into tokens */
-	token = strtok(copy_string, delim);
-	
-	while(token != NULL && count < MAX_TOKENS){
-		tokens[count] = utils_duplicate_string(token);
-		
-		if(tokens[count] == NULL){
-			raise_error(MEMORY_ERROR);
-			exit(FATAL_ERROR);
-		}
-		count++;
-		token = strtok(NULL, delim);
-	}
-	
-	free(copy_string);
-	*tokens_count = count;
-	return tokens;
-}
-
-/* Frees tokens */
-void utils_free_tokens(char** tokens, int token_count){
-	int i;
-	if(tokens == NULL) return;
-	
-	for(i=0; i < token_count; i++){
-		if(tokens[i] != NULL){
-			free(tokens[i]);
-		}
-	}
-	
-	free(tokens);
-}
-
-char* utils_merge_tokens(char** tokens, int token_count) {
-    int i, len = 0;
-    char* result_string;
-
-    /* Calculate the total length of the merged string including spaces and newline */
-    for (i = 0; i < token_count; i++) {
-        len += strlen(tokens[i]) + 1;
-    }
-    
-    /* Add space for spaces between tokens and the newline */
-    len += token_count; /* token_count + spaces */
-
-    /* Allocate memory for the merged string */
-    result_string = (char*)malloc(len * sizeof(char));
-
-    /* Check if memory allocation was successful */
-    if (result_string == NULL) {
-        raise_error(MEMORY_ERROR);
-        exit(FATAL_ERROR);
-    }
-
-    /* Copy the first token to the merged string */
-    strcpy(result_string, tokens[0]);
-
-    /* Add a space and the next token for each subsequent token */
-    for (i = 1; i < token_count; i++) {
-        strcat(result_string, " ");
-        strcat(result_string, tokens[i]);
-    }
-
-    return result_string;
-}
-
-/*
-This function removes spaces in a line and returns pointer to new string
-*/
-char* utils_remove_spaces(char* line) {
-	int size;
-	int i, j = 0;
-	char* result;
-	
-	size = strlen(line);
-	result = (char*)malloc(size * sizeof(char));
-	
-	for(i=0; i < size; i++) {
-		if (line[i] != ' ' && line[i] != '\n' && line[i] != '\t') {
-			result[j++] = line[i];
-		}
-	}
-	result[j] = '\0';
-	
-	return result;
+#include "utils.h"
+#include "error.h"
+#include "constants.h"
+#include <ctype.h>
+
+/* 
+This function takes an input string 'input' and appends the provided 'extension' to it.
+It allocates memory for the new string and returns the pointer to the new string.
+*/
+char* utils_format_file_name(char* input, const char* extension){
+	size_t inputLen = strlen(input);
+    size_t extensionLen = strlen(extension);
+
+    /* Allocate memory for the new string, including space for the extension and the null terminator */
+    char* result = (char*)malloc(inputLen + extensionLen + 1);
+	result[inputLen + extensionLen] = '\0'; /* Null-terminate the string */
+
+	if(result == NULL){
+		raise_error(MEMORY_ERROR);
+		exit(FATAL_ERROR);
+	}
+	
+	strcpy(result, input); /* Copy the input string to the new memory location */
+	strcat(result, extension); /* Concatenate the extension to the new string */
+	
+	return result;
+}
+
+/*
+This function duplicates a string to a new allocated block of memory
+*/
+char* utils_duplicate_string(char* source) {
+    size_t length = strlen(source);
+
+    /* Allocate memory for the new string, including space for the null terminator */
+    char* dest = (char*)malloc(length + 1);
+
+    if (dest != NULL) {
+        /* Copy the content of the 'source' string to the new memory location */
+        strcpy(dest, source);
+    }
+
+    return dest;
+}
+
+/*
+This function finds the next token in a string without copying it, returns a pointer to its
+first char and stores its length, or returns NULL if there are no more tokens
+*/
+char* utils_next_token(char* source, const char* delim, size_t* length) {
+	source += strspn(source, delim); /* Skip delimiters */
+	
+	if(*source == '\0')
+		return NULL;
+	
+	*length = strcspn(source, delim);
+	return source;
+}
+
+/*
+This function counts the tokens in a string
+*/
+int utils_count_tokens(char* source, const char* delim) {
+	int count = 0;
+	size_t length;
+	
+	while((source = utils_next_token(source, delim, &length)) != NULL) {
+		source += length;
+		count++;
+	}
+	
+	return count;
+}
+
+/*
+This function copies the tokens of a string to 'dest' separated by single spaces and null
+terminates 'dest'. 'dest' needs room for the length of the source and 2 more chars, it may
+be the source itself when no trailing space is added. Returns the amount of chars written.
+*/
+size_t utils_normalize_spaces(char* dest, char* source, const char* delim, int trailing_space) {
+	size_t written = 0;
+	size_t length;
+	int count = 0;
+	
+	while((source = utils_next_token(source, delim, &length)) != NULL) {
+		/* Separate from the previous token */
+		if(count > 0 && !trailing_space) {
+			dest[written++] = ' ';
+		}
+		
+		memmove(dest + written, source, length);
+		written += length;
+		source += length;
+		count++;
+		
+		if(trailing_space) {
+			dest[written++] = ' ';
+		}
+	}
+	
+	dest[written] = '\0';
+	return written;
+}
+
+/*
+This function parses a count made only of digits, a count that cannot fit in memory is invalid
+*/
+int utils_parse_count(char* source, size_t length) {
+	int count = 0;
+	size_t i;
+	
+	for(i=0; i < length; i++) {
+		if(!isdigit((unsigned char)source[i]))
+			return INVALID;
+		
+		count = count * 10 + (source[i] - '0');
+		if(count > MEMORY_SIZE)
+			return INVALID;
+	}
+	
+	return (count > 0) ? count : INVALID;
+}
+
+/*
+This function counts the lines in a string, including a last line without a new line
+*/
+int utils_count_lines(char* source) {
+	int count = 0;
+	
+	while(*source != '\0') {
+		if(*source == '\n' || source[1] == '\0') {
+			count++;
+		}
+		source++;
+	}
+	
+	return count;
+}
+
+/*
+This function computes the djb2 hash of a string
+*/
+unsigned long utils_hash_string(char* source) {
+	unsigned long hash = 5381;
+	
+	while(*source != '\0') {
+		hash = ((hash << 5) + hash) + (unsigned char)*source;
+		source++;
+	}
+	
+	return hash;
+}
+
+/*
+This function computes the djb2 hash of a buffer of a given length
+*/
+unsigned long utils_hash_buffer(char* source, size_t length) {
+	unsigned long hash = 5381;
+	size_t i;
+	
+	for(i=0; i < length; i++) {
+		hash = ((hash << 5) + hash) + (unsigned char)source[i];
+	}
+	
+	return hash;
 }
\ No newline at end of file
@@ -1,37 +1,57 @@
-#ifndef UTILS_H
-#define UTILS_H
-
-#include <string.h>
-#include <stdlib.h>
-
-/* 
- * This function takes an input string 'input' and appends the provided 'extension' to it.
- * It allocates memory for the new string and returns the pointer to the new string.
- */
-char* utils_format_file_name(char*, const char*);
-
-/* 
- * This function duplicates a string to a new allocated block of memory.
- */
-char* utils_duplicate_string(char*);
-
-
-char** utils_tokenize(char*, int*, const char*);
-
-/* 
- * Frees memory for an array of tokens.
- */
-void utils_free_tokens(char**, int);
-
-/* 
- * This function merges an array of tokens into a single string, separating each token with spaces.
- * It returns a newly allocated string containing the merged tokens.
- */
-char* utils_merge_tokens(char**, int);
-
-/* 
- * This function removes spaces in a line and returns a pointer to a new string.
- */
-char* utils_remove_spaces(char*);
-
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <string.h>
+#include <stdlib.h>
+
+/* 
+ * This function takes an input string 'input' and appends the provided 'extension' to it.
+ * It allocates memory for the new string and returns the pointer to the new string.
+ */
+char* utils_format_file_name(char*, const char*);
+
+/* 
+ * This function duplicates a string to a new allocated block of memory.
+ */
+char* utils_duplicate_string(char*);
+
+
+/* 
+ * This function finds the next token in a string without copying it.
+ * It returns a pointer to the token's first char and its length, or NULL if there are no more tokens.
+ */
+char* utils_next_token(char*, const char*, size_t*);
+
+/* 
+ * This function counts the tokens in a string.
+ */
+int utils_count_tokens(char*, const char*);
+
+/* 
+ * This function copies the tokens of a string to 'dest', separating each token with a single space,
+ * with a trailing space after the last token if requested. It returns the amount of chars written.
+ */
+size_t utils_normalize_spaces(char*, char*, const char*, int);
+
+/* 
+ * This function parses a count of a given length, returns it if it is between 1 and
+ * MEMORY_SIZE and INVALID otherwise.
+ */
+int utils_parse_count(char*, size_t);
+
+/* 
+ * This function counts the lines in a string, a last line without a new line included.
+ */
+int utils_count_lines(char*);
+
+/* 
+ * This function computes a hash value of a string, used for indexing the tables.
+ */
+unsigned long utils_hash_string(char*);
+
+/* 
+ * This function computes a hash value of a buffer of a given length.
+ */
+unsigned long utils_hash_buffer(char*, size_t);
+
 #endif
\ No newline at end of file
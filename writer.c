@@ -1,112 +1,247 @@
-#include "writer.h"
-#include "utils.h"
-#include "error.h"
-#include "symbol_table.h"
-#include "globals.h"
-#include "constants.h"
-#include "image.h"
-
-/* 
- Open a file for writing with the given file_name and extension
- */
-FILE* writer_open_file(char* file_name, const char* extension){
-    FILE* file;
-    /* Create the full_file_name by concatenating file_name and extension */
-    char* full_file_name = utils_format_file_name(file_name, extension);
-
-    /* Open the file for writing mode */
-    file = fopen(full_file_name, "w");
-
-    /* Check if file opening was successful */
-    if(file == NULL) {
-        raise_error(MEMORY_ERROR);
-        exit(FATAL_ERROR);
-    }
-
-    /* Release memory used for full_file_name, as it is no longer needed */
-    free(full_file_name);
-    return file;
-}
-
-/*
- Write an array of tokens to the given file, separated by spaces, followed by a newline.
- */
-void writer_write_tokens_to_file(FILE* file, char** tokens, int token_count) {
-    int i;
-    
-    /* Check if the file, tokens array, or token_count is invalid, then return immediately */
-    if(file == NULL || tokens == NULL || token_count == 0) return;
-    
-    /* Loop through the tokens array and write each token followed by a space to the file */
-    for(i = 0; i < token_count; i++) {
-        fprintf(file, "%s ", tokens[i]);
-    }
-    fprintf(file, "\n");
-}
-
-/*
- Write a single string to the given file, followed by a newline.
-*/
-void writer_write_string_to_file(FILE* file, char* line) {
-    /* Check if the file or line is invalid, then return immediately */
-    if(file == NULL || line == NULL) return;
-    
-    /* Write the line followed by a newline to the file */
-    fprintf(file, "%s", line);
-}
-
-/*
- Remove a file with the given file_name and extension.
-*/
-void writer_remove_file(char* file_name, const char* extension){
-    /* Create the full_file_name by concatenating file_name and extension */
-    char* full_file_name = utils_format_file_name(file_name, extension);
-
-    /* Remove the file using the remove function from stdio.h */
-    remove(full_file_name);
-
-    /* Release memory used for full_file_name, as it is no longer needed */
-    free(full_file_name);
-}
-
-/*
-This function recieves a file pointer, an external name and an external address
-and writes the name and address to the file
-*/
-void writer_add_ext_to_file(FILE* file, char* ext_name, int ext_address) {
-    if(file == NULL) return;
-    
-    fprintf(file, "%s\t%d\n", ext_name, ext_address);
-}
-
-/*
-This function recieves a file name, creates the output files by the file name with corresponding
-extension, writes a message to stdout and translates the entire image into this output files
-*/
-void writer_write_output_files(char* file_name) {
-    int counter;
-    
-    /* Create .ob and .ent files */
-    FILE* ob_file = writer_open_file(file_name, ".ob");
-    FILE* ent_file = writer_open_file(file_name, ".ent");
-    
-    printf("Translating files...\n");
-    
-    fprintf(ob_file, "%d %d\n", ic - MEMORY_OFFSET, dc);
-    
-    /* Translate image to ob file */
-    image_translate(ob_file);
-    
-    /* Write all entries symbols to ent file */
-    counter = symbol_table_make_ent_file(ent_file);
-    
-    /* If no entries written than remove .ent file */
-    if(counter == 0) {
-        printf("No entries found!\nRemoving ENT file...\n");
-        writer_remove_file(file_name, ".ent");
-    }
-    
-    /* Close files */
-    fclose(ob_file);
-    fclose(ent_file);
-}
+#include "writer.h"
+#include "utils.h"
+#include "error.h"
+#include "symbol_table.h"
+#include "constants.h"
+#include "image.h"
+#include "line_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define INT_DIGITS 12 /* Enough chars for the sign and digits of an int */
+
+/* 
+ Open a file for writing with the given file_name and extension
+ */
+FILE* writer_open_file(char* file_name, const char* extension){
+    FILE* file;
+    /* Create the full_file_name by concatenating file_name and extension */
+    char* full_file_name = utils_format_file_name(file_name, extension);
+
+    /* Open the file for writing mode */
+    file = fopen(full_file_name, "w");
+
+    /* Check if file opening was successful */
+    if(file == NULL) {
+        raise_error(MEMORY_ERROR);
+        exit(FATAL_ERROR);
+    }
+    
+    /* Output is assembled in memory and written at once, so the stream needs no buffer of its own */
+    setvbuf(file, NULL, _IONBF, 0);
+
+    /* Release memory used for full_file_name, as it is no longer needed */
+    free(full_file_name);
+    return file;
+}
+
+/*
+ Create a new empty output buffer.
+*/
+output_buffer* writer_buffer_new() {
+    output_buffer* buffer = (output_buffer*)malloc(sizeof(output_buffer));
+    
+    if(buffer == NULL) {
+        raise_error(MEMORY_ERROR);
+        exit(FATAL_ERROR);
+    }
+    
+    buffer->data = (char*)malloc(BUFFER_BASE_SIZE);
+    if(buffer->data == NULL) {
+        raise_error(MEMORY_ERROR);
+        exit(FATAL_ERROR);
+    }
+    
+    buffer->length = 0;
+    buffer->capacity = BUFFER_BASE_SIZE;
+    return buffer;
+}
+
+/*
+ Free an output buffer and its contents.
+*/
+void writer_buffer_free(output_buffer* buffer) {
+    if(buffer == NULL) return;
+    
+    free(buffer->data);
+    free(buffer);
+}
+
+/*
+ Make room for an amount of chars at the end of the buffer, doubling it as needed,
+ and return where they start.
+*/
+char* writer_buffer_reserve(output_buffer* buffer, size_t length) {
+    size_t capacity = buffer->capacity;
+    
+    if(buffer->length + length > capacity) {
+        while(buffer->length + length > capacity) {
+            capacity *= 2;
+        }
+        
+        buffer->data = (char*)realloc(buffer->data, capacity);
+        if(buffer->data == NULL) {
+            raise_error(MEMORY_ERROR);
+            exit(FATAL_ERROR);
+        }
+        buffer->capacity = capacity;
+    }
+    
+    return buffer->data + buffer->length;
+}
+
+/*
+ Commit an amount of chars written after a reserve.
+*/
+void writer_buffer_advance(output_buffer* buffer, size_t length) {
+    buffer->length += length;
+}
+
+/*
+ Append a single char to the buffer.
+*/
+void writer_buffer_add_char(output_buffer* buffer, char c) {
+    *writer_buffer_reserve(buffer, 1) = c;
+    buffer->length++;
+}
+
+/*
+ Append a string, without its null character, to the buffer.
+*/
+void writer_buffer_add_string(output_buffer* buffer, const char* text) {
+    size_t length;
+    
+    if(text == NULL) return;
+    
+    length = strlen(text);
+    memcpy(writer_buffer_reserve(buffer, length), text, length);
+    buffer->length += length;
+}
+
+/*
+ Append the decimal representation of an integer to the buffer. The digits are
+ written backwards from the end of a small array and copied at once.
+*/
+void writer_buffer_add_int(output_buffer* buffer, int num) {
+    char digits[INT_DIGITS];
+    int start = INT_DIGITS;
+    /* Work on the magnitude as unsigned so the smallest int does not overflow */
+    unsigned int magnitude = (num < 0) ? 0u - (unsigned int)num : (unsigned int)num;
+    
+    do {
+        digits[--start] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while(magnitude > 0);
+    
+    if(num < 0) {
+        digits[--start] = '-';
+    }
+    
+    memcpy(writer_buffer_reserve(buffer, (size_t)(INT_DIGITS - start)), digits + start, (size_t)(INT_DIGITS - start));
+    buffer->length += (size_t)(INT_DIGITS - start);
+}
+
+/*
+ Write the contents of a buffer to a new file with the given file_name and extension.
+ The file is unbuffered, so the whole contents go out in a single write.
+*/
+void writer_flush_buffer(output_buffer* buffer, char* file_name, const char* extension) {
+    FILE* file = writer_open_file(file_name, extension);
+    
+    writer_write_buffer_to_file(file, buffer->data, buffer->length);
+    fclose(file);
+}
+
+/*
+ Write a buffer of a known length to the given file in a single write.
+*/
+void writer_write_buffer_to_file(FILE* file, char* buffer, size_t length) {
+    /* Check if the file or buffer is invalid, then return immediately */
+    if(file == NULL || buffer == NULL) return;
+    
+    fwrite(buffer, sizeof(char), length, file);
+}
+
+/*
+ Remove a file with the given file_name and extension.
+*/
+void writer_remove_file(char* file_name, const char* extension){
+    /* Create the full_file_name by concatenating file_name and extension */
+    char* full_file_name = utils_format_file_name(file_name, extension);
+
+    /* Remove the file using the remove function from stdio.h */
+    remove(full_file_name);
+
+    /* Release memory used for full_file_name, as it is no longer needed */
+    free(full_file_name);
+}
+
+/*
+This function recieves an output buffer, an external name and an external address
+and appends the name and address to the buffer
+*/
+void writer_add_ext_to_buffer(output_buffer* buffer, char* ext_name, int ext_address) {
+    if(buffer == NULL) return;
+    
+    writer_buffer_add_string(buffer, ext_name);
+    writer_buffer_add_char(buffer, '\t');
+    writer_buffer_add_int(buffer, ext_address);
+    writer_buffer_add_char(buffer, '\n');
+}
+
+/*
+This function recieves a file name and writes the pre-assembled line table to the .am file
+*/
+void writer_write_am_file(assembler_ctx* ctx, char* file_name) {
+    output_buffer* am = writer_buffer_new();
+    
+    line_table_write_to_buffer(ctx, am);
+    writer_flush_buffer(am, file_name, ".am");
+    writer_buffer_free(am);
+}
+
+/*
+This function recieves a file name, creates the output files by the file name with corresponding
+extension, writes a message to stdout and translates the entire image into this output files.
+The .ent and .ext files are created only if they have lines, otherwise a file left
+by an earlier run is removed
+*/
+void writer_write_output_files(assembler_ctx* ctx, char* file_name) {
+    output_buffer* ob = writer_buffer_new();
+    output_buffer* listing; /* .ent or .ext file, created only if it has lines */
+    
+    context_message(ctx, "Translating files...\n");
+    
+    writer_buffer_add_int(ob, ctx->ic);
+    writer_buffer_add_char(ob, ' ');
+    writer_buffer_add_int(ob, ctx->dc);
+    writer_buffer_add_char(ob, '\n');
+    
+    /* Translate image to ob file */
+    image_translate(ctx, ob);
+    writer_flush_buffer(ob, file_name, ".ob");
+    
+    writer_buffer_free(ob);
+    
+    /* Write all entries symbols to ent file */
+    if(symbol_table_get_entry_length(ctx) > 0) {
+        listing = writer_buffer_new();
+        symbol_table_make_ent_file(ctx, listing);
+        writer_flush_buffer(listing, file_name, ".ent");
+        writer_buffer_free(listing);
+    } else {
+        writer_remove_file(file_name, ".ent");
+        context_message(ctx, "No entries found!\n");
+    }
+    
+    /* Write every use of an extern symbol to ext file */
+    if(symbol_table_get_extern_use_length(ctx) > 0) {
+        listing = writer_buffer_new();
+        symbol_table_make_ext_file(ctx, listing);
+        writer_flush_buffer(listing, file_name, ".ext");
+        writer_buffer_free(listing);
+    } else {
+        writer_remove_file(file_name, ".ext");
+        context_message(ctx, "No externals found!\n");
+    }
+}
\ No newline at end of file
@@ -1,39 +1,92 @@
-#ifndef WRITER_H
-#define WRITER_H
-
-#include <stdio.h>
-
-/*
-* Open a file for writing with given file_name and extension
-*/
-FILE* writer_open_file(char*, const char*);
-
-/*
-* This function writes an array of tokens to given file, seperated by spaces
-* and followed by a new line
-*/
-void writer_write_tokens_to_file(FILE*, char**, int);
-
-/*
-* This function writes a string to a given file followed by a new line
-*/
-void writer_write_string_to_file(FILE*, char*);
-
-/*
-* Recieves a file name and an extension and removes the file
-*/
-void writer_remove_file(char*, const char* extension);
-
-/*
-* This function recieves a filepointer, external name, address and writes it
-* to given file
-*/
-void writer_add_ext_to_file(FILE*, char*, int);
-
-/*
-* This function recieves a filename, creates the output files and translates
-* the entire image into output files
-*/
-void writer_write_output_files();
-
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "context.h"
+
+/*
+* An output file assembled in memory, written to disk in a single write
+*/
+typedef struct OutputBuffer {
+	char* data; /* Contents of the file, not null terminated */
+	size_t length; /* Amount of chars written */
+	size_t capacity; /* Amount of chars the data can hold */
+} output_buffer;
+
+/*
+* Open a file for writing with given file_name and extension
+*/
+FILE* writer_open_file(char*, const char*);
+
+/*
+* This function creates a new empty output buffer
+*/
+output_buffer* writer_buffer_new();
+
+/*
+* This function frees an output buffer
+*/
+void writer_buffer_free(output_buffer*);
+
+/*
+* This function makes room for an amount of chars at the end of a buffer and
+* returns where they start, writer_buffer_advance commits the chars written
+*/
+char* writer_buffer_reserve(output_buffer*, size_t);
+
+/*
+* This function adds an amount of chars written after a reserve to the buffer
+*/
+void writer_buffer_advance(output_buffer*, size_t);
+
+/*
+* This function appends a single char to a buffer
+*/
+void writer_buffer_add_char(output_buffer*, char);
+
+/*
+* This function appends a string to a buffer
+*/
+void writer_buffer_add_string(output_buffer*, const char*);
+
+/*
+* This function appends the decimal representation of an integer to a buffer
+*/
+void writer_buffer_add_int(output_buffer*, int);
+
+/*
+* This function writes the contents of a buffer to a new file with given
+* file_name and extension in a single write
+*/
+void writer_flush_buffer(output_buffer*, char*, const char*);
+
+/*
+* This function writes a buffer of a known length to a given file in a single write
+*/
+void writer_write_buffer_to_file(FILE*, char*, size_t);
+
+/*
+* Recieves a file name and an extension and removes the file
+*/
+void writer_remove_file(char*, const char* extension);
+
+/*
+* This function recieves an output buffer, external name, address and appends
+* it to given buffer
+*/
+void writer_add_ext_to_buffer(output_buffer*, char*, int);
+
+/*
+* This function recieves a filename and writes the pre-assembled line table to
+* its .am file
+*/
+void writer_write_am_file(assembler_ctx*, char*);
+
+/*
+* This function recieves a filename, creates the output files and translates
+* the entire image into output files
+*/
+void writer_write_output_files(assembler_ctx*, char*);
+
 #endif
\ No newline at end of file